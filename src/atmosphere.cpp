@@ -0,0 +1,86 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "atmosphere.h"
+
+#include <QGlobalStatic>
+
+#include <math.h>
+
+#include "common.h"
+
+namespace
+{
+
+// Linear interpolation at this spacing is accurate to about 1e-7
+const double TABLE_MIN  = -2000;
+const double TABLE_MAX  = 20000;
+const double TABLE_STEP = 5;
+const int    TABLE_SIZE = 4401;     // (TABLE_MAX - TABLE_MIN) / TABLE_STEP + 1
+
+class DensityTable
+{
+public:
+    DensityTable()
+    {
+        for (int i = 0; i < TABLE_SIZE; ++i)
+        {
+            values[i] = Atmosphere::densityExact(TABLE_MIN + i * TABLE_STEP);
+        }
+    }
+
+    double values[TABLE_SIZE];
+};
+
+Q_GLOBAL_STATIC(DensityTable, densityTable)
+
+} // namespace
+
+double Atmosphere::density(
+        double altitude)
+{
+    // Written this way so NaN also takes the exact path
+    if (!(altitude >= TABLE_MIN && altitude < TABLE_MAX))
+    {
+        return densityExact(altitude);
+    }
+
+    const double u = (altitude - TABLE_MIN) / TABLE_STEP;
+    const int i = (int) u;
+    const double *values = densityTable()->values;
+
+    return values[i] + (u - i) * (values[i + 1] - values[i]);
+}
+
+double Atmosphere::densityExact(
+        double altitude)
+{
+    // From https://en.wikipedia.org/wiki/Atmospheric_pressure#Altitude_variation
+    const double airPressure = SL_PRESSURE * pow(1 - LAPSE_RATE * altitude / SL_TEMP, A_GRAVITY * MM_AIR / GAS_CONST / LAPSE_RATE);
+
+    // From https://en.wikipedia.org/wiki/Lapse_rate
+    const double temperature = SL_TEMP - LAPSE_RATE * altitude;
+
+    // From https://en.wikipedia.org/wiki/Density_of_air
+    return airPressure / (GAS_CONST / MM_AIR) / temperature;
+}
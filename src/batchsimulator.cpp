@@ -0,0 +1,218 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "batchsimulator.h"
+#include "fitnessevaluator.h"
+#include "genome.h"
+#include "trajectory.h"
+
+BatchSimulator::BatchSimulator():
+    mCapacity(0)
+{
+
+}
+
+void BatchSimulator::reserve(
+        int count)
+{
+    if (count <= mCapacity) return;
+
+    mCapacity = count;
+    mData.resize(NumColumns * mCapacity);
+    mLane.resize(mCapacity);
+}
+
+void BatchSimulator::moveLane(
+        int from,
+        int to)
+{
+    for (int c = 0; c < NumColumns; ++c)
+    {
+        double *values = column((Column) c);
+        values[to] = values[from];
+    }
+
+    mLane[to] = mLane[from];
+}
+
+void BatchSimulator::simulate(
+        double h,
+        double a,
+        double c,
+        double planformArea,
+        double mass,
+        const DataPoint &dp0,
+        double windowBottom,
+        const Genome *const *genomes,
+        int count,
+        Trajectory *trajectories,
+        FitnessEvaluator *const *evaluators)
+{
+    reserve(count);
+
+    double *theta    = column(Theta);
+    double *v        = column(V);
+    double *x        = column(X);
+    double *y        = column(Y);
+    double *dist2D   = column(Dist2D);
+    double *dist3D   = column(Dist3D);
+    double *liftPrev = column(LiftPrev);
+    double *dragPrev = column(DragPrev);
+    double *liftNext = column(LiftNext);
+    double *dragNext = column(DragNext);
+    double *dTheta   = column(DTheta);
+    double *dV       = column(DV);
+    double *dX       = column(DX);
+    double *dY       = column(DY);
+    double *sumTheta = column(SumTheta);
+    double *sumV     = column(SumV);
+    double *sumX     = column(SumX);
+    double *sumY     = column(SumY);
+
+    const double velH = sqrt(dp0.vx * dp0.vx + dp0.vy * dp0.vy);
+
+    const double theta0 = atan2(-dp0.velD, velH);
+    const double v0     = sqrt(dp0.velD * dp0.velD + velH * velH);
+
+    const double yBottom = windowBottom - dp0.z + dp0.hMSL;
+    const double k = planformArea / mass;
+
+    // Initialize lanes
+    int n = 0;
+    for (int j = 0; j < count; ++j)
+    {
+        trajectories[j].start(dp0, theta0, v0, genomes[j]->size());
+        if (evaluators) evaluators[j]->start(trajectories[j]);
+
+        if (genomes[j]->size() < 2) continue;
+
+        theta[n]  = theta0;
+        v[n]      = v0;
+        x[n]      = 0;
+        y[n]      = dp0.hMSL;
+        dist2D[n] = dp0.dist2D;
+        dist3D[n] = dp0.dist3D;
+        mLane[n]  = j;
+        ++n;
+    }
+
+    double t = dp0.t;
+
+    for (int i = 0; n > 0; ++i)
+    {
+        // Gather lift and drag for this step
+        for (int j = 0; j < n; ++j)
+        {
+            const Genome &genome = *genomes[mLane[j]];
+
+            liftPrev[j] = Genome::lift(genome.at(i));
+            dragPrev[j] = Genome::drag(genome.at(i), a, c);
+
+            liftNext[j] = Genome::lift(genome.at(i + 1));
+            dragNext[j] = Genome::drag(genome.at(i + 1), a, c);
+        }
+
+        // Runge-Kutta integration, one stage at a time across all lanes
+        for (int j = 0; j < n; ++j)
+        {
+            Genome::derivatives(theta[j], v[j], y[j], liftPrev[j], dragPrev[j], k, h,
+                                dTheta[j], dV[j], dX[j], dY[j]);
+
+            sumTheta[j] = dTheta[j];
+            sumV[j]     = dV[j];
+            sumX[j]     = dX[j];
+            sumY[j]     = dY[j];
+        }
+
+        for (int stage = 1; stage < 3; ++stage)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                const double liftMid = (liftPrev[j] + liftNext[j]) / 2;
+                const double dragMid = (dragPrev[j] + dragNext[j]) / 2;
+
+                Genome::derivatives(theta[j] + dTheta[j]/2, v[j] + dV[j]/2, y[j] + dY[j]/2,
+                                    liftMid, dragMid, k, h,
+                                    dTheta[j], dV[j], dX[j], dY[j]);
+
+                sumTheta[j] += 2 * dTheta[j];
+                sumV[j]     += 2 * dV[j];
+                sumX[j]     += 2 * dX[j];
+                sumY[j]     += 2 * dY[j];
+            }
+        }
+
+        for (int j = 0; j < n; ++j)
+        {
+            Genome::derivatives(theta[j] + dTheta[j], v[j] + dV[j], y[j] + dY[j],
+                                liftNext[j], dragNext[j], k, h,
+                                dTheta[j], dV[j], dX[j], dY[j]);
+
+            const double dx = (sumX[j] + dX[j]) / 6;
+            const double dy = (sumY[j] + dY[j]) / 6;
+
+            theta[j] += (sumTheta[j] + dTheta[j]) / 6;
+            v[j]     += (sumV[j] + dV[j]) / 6;
+            x[j]     += dx;
+            y[j]     += dy;
+
+            dist2D[j] += dx;
+            dist3D[j] += sqrt(dx * dx + dy * dy);
+        }
+
+        t += h;
+
+        // Record states and retire finished lanes
+        for (int j = 0; j < n; )
+        {
+            const int lane = mLane[j];
+
+            Trajectory::State state;
+
+            state.t      = t;
+            state.theta  = theta[j];
+            state.v      = v[j];
+            state.x      = x[j];
+            state.y      = y[j];
+            state.dist2D = dist2D[j];
+            state.dist3D = dist3D[j];
+            state.lift   = liftNext[j];
+            state.drag   = dragNext[j];
+
+            trajectories[lane].append(state);
+
+            const bool done = (evaluators && !evaluators[lane]->add(trajectories[lane]))
+                    || state.y < yBottom
+                    || i + 2 >= genomes[lane]->size();
+
+            if (done)
+            {
+                moveLane(--n, j);
+            }
+            else
+            {
+                ++j;
+            }
+        }
+    }
+}
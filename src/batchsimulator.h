@@ -0,0 +1,70 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef BATCHSIMULATOR_H
+#define BATCHSIMULATOR_H
+
+#include <QVector>
+
+#include "datapoint.h"
+
+class FitnessEvaluator;
+class Genome;
+class Trajectory;
+
+// Simulates several genomes in lockstep. Lane state is stored by column
+// so each Runge-Kutta stage is a simple loop over the active lanes, and
+// lanes which reach the bottom of the window are swapped out of the
+// working set. Results are identical to Genome::simulate.
+
+class BatchSimulator
+{
+public:
+    BatchSimulator();
+
+    void simulate(double h, double a, double c,
+                  double planformArea, double mass,
+                  const DataPoint &dp0, double windowBottom,
+                  const Genome *const *genomes, int count,
+                  Trajectory *trajectories,
+                  FitnessEvaluator *const *evaluators = 0);
+
+private:
+    typedef enum {
+        Theta, V, X, Y, Dist2D, Dist3D,
+        LiftPrev, DragPrev, LiftNext, DragNext,
+        DTheta, DV, DX, DY,
+        SumTheta, SumV, SumX, SumY,
+        NumColumns
+    } Column;
+
+    QVector< double >   mData;
+    QVector< int >      mLane;
+    int                 mCapacity;
+
+    void reserve(int count);
+    double *column(Column c) { return mData.data() + c * mCapacity; }
+    void moveLane(int from, int to);
+};
+
+#endif // BATCHSIMULATOR_H
@@ -0,0 +1,29 @@
+#-------------------------------------------------
+#
+# Benchmarks on synthetic tracks
+#
+#-------------------------------------------------
+
+QT       += core gui printsupport widgets concurrent testlib
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x000000
+
+TARGET = FlySightBench
+TEMPLATE = app
+
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += main.cpp \
+    benchmarks.cpp \
+    legacyparser.cpp \
+    trackgenerator.cpp \
+    ../QCustomPlot/qcustomplot.cpp
+
+HEADERS  += benchmarks.h \
+    legacyparser.h \
+    trackgenerator.h \
+    ../plotvalue.h \
+    ../QCustomPlot/qcustomplot.h
+
+include(../core/core.pri)
@@ -0,0 +1,732 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "benchmarks.h"
+
+#include <QTemporaryFile>
+#include <QtTest>
+
+#include <math.h>
+
+#include "atmosphere.h"
+#include "batchsimulator.h"
+#include "fitnesscache.h"
+#include "fitnessevaluator.h"
+#include "fitnessfunction.h"
+#include "geneticoptimizer.h"
+#include "genome.h"
+#include "kinematics.h"
+#include "legacyparser.h"
+#include "mappath.h"
+#include "minmaxpyramid.h"
+#include "plotvalue.h"
+#include "QCustomPlot/qcustomplot.h"
+#include "scoringrules.h"
+#include "trackgenerator.h"
+#include "trajectory.h"
+
+namespace
+{
+
+const quint64 seed           = 1;
+const double  exitSpeed      = 10;      // Vertical speed which marks exit (m/s)
+const double  windowTop      = 3000;    // PPC window (m)
+const double  windowBottom   = 2000;
+const int     numGenomes     = 64;      // Candidates per simulation benchmark
+const int     batchSize      = 8;       // Matches the optimizer
+const int     plotWidth      = 1200;    // Data plot size (pixels)
+const int     plotHeight     = 600;
+const int     zoomSteps      = 20;      // Views per pass across the track
+
+// PPC distance, as scored by the optimizer
+class DistanceEvaluator : public WindowEvaluator
+{
+public:
+    DistanceEvaluator(): WindowEvaluator(windowTop, windowBottom) {}
+
+protected:
+    double score(const Crossing &top, const Crossing &bottom) const
+    {
+        const double dx = bottom.x - top.x;
+        const double dy = bottom.y - top.y;
+        return sqrt(dx * dx + dy * dy);
+    }
+};
+
+class DistanceFunction : public FitnessFunction
+{
+public:
+    double score(const QVector< DataPoint > &) { return 0; }
+    FitnessEvaluator *createEvaluator() const { return new DistanceEvaluator; }
+    FitnessCache *fitnessCache() { return &mFitnessCache; }
+
+private:
+    FitnessCache mFitnessCache;
+};
+
+void addTrackRow(
+        TrackGenerator::Profile profile,
+        double rate,
+        double duration)
+{
+    const QString tag = TrackGenerator::profileName(profile)
+            + QString("/%1Hz/%2min").arg(rate).arg(duration / 60);
+
+    QTest::newRow(qPrintable(tag)) << (int) profile << rate << duration;
+}
+
+Kinematics::Parameters trackParameters(
+        const Track &track)
+{
+    Kinematics::Parameters params = track.parameters();
+    params.exit = Kinematics::findExit(track.data(), exitSpeed);
+    params.ground = track.last().hMSL;
+    return params;
+}
+
+// Defaults from the viewer's simulation settings
+Optimizer::Parameters optimizerParameters(
+        const Track &track,
+        Optimizer::Simulator simulator)
+{
+    Optimizer::Parameters params;
+
+    params.dp0 = track.interpolateT(0);
+    params.windowBottom = windowBottom;
+
+    const double maxLD = 3;
+    const double m = 1 / maxLD;
+    params.c = 0.05;
+    params.a = m * m / (4 * params.c);
+
+    params.minLift = 0;
+    params.maxLift = 0.5;
+    params.planformArea = 2;
+    params.mass = 70;
+    params.simulationTime = 120;
+
+    params.seed = seed;
+    params.simulator = simulator;
+
+    return params;
+}
+
+// Series shown by the data plot
+QList< PlotValue * > plotValues()
+{
+    QList< PlotValue * > values;
+    values << new PlotElevation
+           << new PlotVerticalSpeed
+           << new PlotHorizontalSpeed
+           << new PlotTotalSpeed
+           << new PlotGlideRatio;
+    return values;
+}
+
+// Every series the data plot can show
+QList< PlotValue * > allPlotValues()
+{
+    QList< PlotValue * > values;
+    values << new PlotTime
+           << new PlotDistance2D
+           << new PlotDistance3D
+           << new PlotElevation
+           << new PlotVerticalSpeed
+           << new PlotHorizontalSpeed
+           << new PlotTotalSpeed
+           << new PlotDiveAngle
+           << new PlotCurvature
+           << new PlotGlideRatio
+           << new PlotHorizontalAccuracy
+           << new PlotVerticalAccuracy
+           << new PlotSpeedAccuracy
+           << new PlotNumberOfSatellites
+           << new PlotAcceleration
+           << new PlotTotalEnergy
+           << new PlotEnergyRate
+           << new PlotLift
+           << new PlotDrag
+           << new PlotCourse
+           << new PlotCourseRate
+           << new PlotCourseAccuracy;
+    return values;
+}
+
+// Same steps as DataPlot::updateSeries()
+void sampleGraphs(
+        QCustomPlot &plot,
+        const QVector< MinMaxPyramid > &pyramids,
+        double lower,
+        double upper)
+{
+    QVector< double > x, y;
+    for (int j = 0; j < pyramids.size(); ++j)
+    {
+        pyramids[j].sample(lower, upper, plotWidth, x, y);
+        plot.graph(j)->setData(x, y, true);
+    }
+}
+
+// Same steps as DataPlot::updatePlot()
+void addGraphs(
+        QCustomPlot &plot,
+        const QVector< DataPoint > &data,
+        const PlotValue &xValue,
+        const QList< PlotValue * > &yValues,
+        QVector< MinMaxPyramid > &pyramids)
+{
+    plot.clearGraphs();
+    pyramids.clear();
+
+    const QVector< double > x = xValue.values(data, PlotValue::Metric);
+
+    for (int j = 0; j < yValues.size(); ++j)
+    {
+        const QVector< double > y = yValues[j]->values(data, PlotValue::Metric);
+
+        QCPGraph *graph = plot.addGraph(plot.xAxis, yValues[j]->axis());
+        graph->setPen(QPen(yValues[j]->color(), 1));
+
+        pyramids.append(MinMaxPyramid(x, y));
+    }
+
+    // Same steps as DataPlot::updateSeries() over the whole track
+    sampleGraphs(plot, pyramids, x.first(), x.last());
+}
+
+} // namespace
+
+void Benchmarks::addTrackRows()
+{
+    QTest::addColumn< int >("profile");
+    QTest::addColumn< double >("rate");
+    QTest::addColumn< double >("duration");
+
+    // Each profile at a typical rate and length
+    addTrackRow(TrackGenerator::Skydive, 5, 600);
+    addTrackRow(TrackGenerator::Wingsuit, 5, 600);
+    addTrackRow(TrackGenerator::Canopy, 5, 600);
+
+    // Sample rate
+    addTrackRow(TrackGenerator::Wingsuit, 1, 600);
+    addTrackRow(TrackGenerator::Wingsuit, 25, 600);
+    addTrackRow(TrackGenerator::Wingsuit, 100, 600);
+
+    // Recording length
+    addTrackRow(TrackGenerator::Wingsuit, 5, 3600);
+    addTrackRow(TrackGenerator::Wingsuit, 5, 10800);
+    addTrackRow(TrackGenerator::Wingsuit, 100, 3600);
+}
+
+void Benchmarks::addSimulatorRows()
+{
+    QTest::addColumn< int >("simulator");
+
+    QTest::newRow("scalar") << (int) Optimizer::Scalar;
+    QTest::newRow("batched") << (int) Optimizer::Batched;
+}
+
+QByteArray Benchmarks::trackData()
+{
+    QFETCH(int, profile);
+    QFETCH(double, rate);
+    QFETCH(double, duration);
+
+    // Generated files are shared by all benchmarks
+    const QString key = QTest::currentDataTag();
+    if (!mTracks.contains(key))
+    {
+        mTracks.insert(key, TrackGenerator::generate(
+                           (TrackGenerator::Profile) profile,
+                           rate, duration, seed));
+    }
+
+    return mTracks.value(key);
+}
+
+Track Benchmarks::initializedTrack()
+{
+    const QByteArray csv = trackData();
+
+    Track track;
+    track.parse(csv.constData(), csv.constData() + csv.size());
+    track.initialize(trackParameters(track));
+
+    return track;
+}
+
+void Benchmarks::parse_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::parse()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(trackData());
+    file.close();
+
+    Track track;
+    QBENCHMARK
+    {
+        track.load(file.fileName());
+    }
+
+    QVERIFY(!track.isEmpty());
+}
+
+void Benchmarks::parseLegacy_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::parseLegacy()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(trackData());
+    file.close();
+
+    QVector< DataPoint > data;
+    QBENCHMARK
+    {
+        QFile in(file.fileName());
+        in.open(QIODevice::ReadOnly);
+        LegacyParser::parse(&in, data);
+    }
+
+    QVERIFY(!data.isEmpty());
+}
+
+void Benchmarks::initialize_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::initialize()
+{
+    const QByteArray csv = trackData();
+
+    Track track;
+    track.parse(csv.constData(), csv.constData() + csv.size());
+
+    const Kinematics::Parameters params = trackParameters(track);
+
+    // Derived channels are overwritten on every pass
+    QVector< DataPoint > data = track.data();
+    data.detach();
+
+    QBENCHMARK
+    {
+        Kinematics::initialize(data, params);
+    }
+}
+
+void Benchmarks::updateWind_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::updateWind()
+{
+    const Track track = initializedTrack();
+
+    Kinematics::Parameters from = track.parameters();
+    Kinematics::Parameters to = from;
+    to.windE = 3;
+    to.windN = -2;
+
+    QVector< DataPoint > data = track.data();
+    data.detach();
+
+    // Alternate between the two winds
+    QBENCHMARK
+    {
+        Kinematics::update(data, from, to);
+        qSwap(from, to);
+    }
+}
+
+void Benchmarks::columns_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::columns()
+{
+    const Track track = initializedTrack();
+
+    QList< PlotValue * > values = allPlotValues();
+
+    QBENCHMARK
+    {
+        for (int j = 0; j < values.size(); ++j)
+        {
+            const QVector< double > column = values[j]->values(track.data(), PlotValue::Imperial);
+            QVERIFY(column.size() == track.data().size());
+        }
+    }
+
+    qDeleteAll(values);
+}
+
+void Benchmarks::plotData_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::plotData()
+{
+    const Track track = initializedTrack();
+
+    QCustomPlot plot;
+    PlotTime xValue;
+    QList< PlotValue * > yValues = plotValues();
+    for (int j = 0; j < yValues.size(); ++j)
+    {
+        yValues[j]->addAxis(&plot, PlotValue::Metric);
+    }
+
+    QVector< MinMaxPyramid > pyramids;
+
+    QBENCHMARK
+    {
+        addGraphs(plot, track.data(), xValue, yValues, pyramids);
+    }
+
+    qDeleteAll(yValues);
+}
+
+void Benchmarks::zoom_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::zoom()
+{
+    const Track track = initializedTrack();
+
+    QCustomPlot plot;
+    PlotTime xValue;
+    QList< PlotValue * > yValues = plotValues();
+    for (int j = 0; j < yValues.size(); ++j)
+    {
+        yValues[j]->addAxis(&plot, PlotValue::Metric);
+    }
+
+    QVector< MinMaxPyramid > pyramids;
+    addGraphs(plot, track.data(), xValue, yValues, pyramids);
+
+    // Pan a view one tenth of the track wide from start to end
+    const double start = xValue.value(track.data().first(), PlotValue::Metric);
+    const double end = xValue.value(track.data().last(), PlotValue::Metric);
+    const double width = (end - start) / 10;
+
+    QBENCHMARK
+    {
+        for (int i = 0; i < zoomSteps; ++i)
+        {
+            const double lower = start + (end - start - width) * i / (zoomSteps - 1);
+            sampleGraphs(plot, pyramids, lower, lower + width);
+        }
+    }
+
+    qDeleteAll(yValues);
+}
+
+void Benchmarks::autoscale_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::autoscale()
+{
+    const Track track = initializedTrack();
+
+    QCustomPlot plot;
+    PlotTime xValue;
+    QList< PlotValue * > yValues = plotValues();
+    for (int j = 0; j < yValues.size(); ++j)
+    {
+        yValues[j]->addAxis(&plot, PlotValue::Metric);
+    }
+
+    QVector< MinMaxPyramid > pyramids;
+    addGraphs(plot, track.data(), xValue, yValues, pyramids);
+
+    // Same views as the zoom benchmark, as in DataPlot::updateYRanges()
+    const double start = xValue.value(track.data().first(), PlotValue::Metric);
+    const double end = xValue.value(track.data().last(), PlotValue::Metric);
+    const double width = (end - start) / 10;
+
+    QBENCHMARK
+    {
+        for (int i = 0; i < zoomSteps; ++i)
+        {
+            const double lower = start + (end - start - width) * i / (zoomSteps - 1);
+            for (int j = 0; j < pyramids.size(); ++j)
+            {
+                double yMin, yMax;
+                if (pyramids[j].extrema(lower, lower + width, yMin, yMax))
+                {
+                    yValues[j]->axis()->setRange(yMin, yMax);
+                }
+            }
+        }
+    }
+
+    qDeleteAll(yValues);
+}
+
+void Benchmarks::replot_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::replot()
+{
+    const Track track = initializedTrack();
+
+    QCustomPlot plot;
+    plot.resize(plotWidth, plotHeight);
+    plot.setViewport(QRect(0, 0, plotWidth, plotHeight));
+
+    PlotTime xValue;
+    QList< PlotValue * > yValues = plotValues();
+    for (int j = 0; j < yValues.size(); ++j)
+    {
+        yValues[j]->addAxis(&plot, PlotValue::Metric);
+    }
+
+    QVector< MinMaxPyramid > pyramids;
+    addGraphs(plot, track.data(), xValue, yValues, pyramids);
+    plot.rescaleAxes();
+
+    QBENCHMARK
+    {
+        plot.replot();
+    }
+
+    qDeleteAll(yValues);
+}
+
+void Benchmarks::mapPath_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::mapPath()
+{
+    const Track track = initializedTrack();
+
+    // Street level, as in MapView::updateView()
+    const double earthCircumference = 40075000;
+    const double zoom = 15;
+    const double width = 800;
+    const double threshold = earthCircumference / pow(2, zoom) / width;
+
+    QString script;
+    QBENCHMARK
+    {
+        const QVector< int > indices = MapPath::decimate(
+                    track.data(), track.first().t, track.last().t, threshold);
+        script = MapPath::script(track.data(), indices);
+    }
+
+    QVERIFY(!script.isEmpty());
+}
+
+void Benchmarks::windFit_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::windFit()
+{
+    const Track track = initializedTrack();
+
+    double windE, windN, velAircraft;
+    QBENCHMARK
+    {
+        Kinematics::fitWind(track.data(), 0, track.size() - 1,
+                            windE, windN, velAircraft);
+    }
+}
+
+void Benchmarks::windowBounds_data()
+{
+    addTrackRows();
+}
+
+void Benchmarks::windowBounds()
+{
+    const Track track = initializedTrack();
+
+    DataPoint dpBottom, dpTop;
+    QBENCHMARK
+    {
+        ScoringRules::windowBounds(track.data(), windowTop, windowBottom,
+                                   dpBottom, dpTop);
+    }
+}
+
+void Benchmarks::density_data()
+{
+    QTest::addColumn< bool >("exact");
+
+    QTest::newRow("table") << false;
+    QTest::newRow("exact") << true;
+}
+
+void Benchmarks::density()
+{
+    QFETCH(bool, exact);
+
+    double sum = 0;
+    QBENCHMARK
+    {
+        for (double altitude = 0; altitude < 6000; altitude += 0.1)
+        {
+            sum += exact ? Atmosphere::densityExact(altitude)
+                         : Atmosphere::density(altitude);
+        }
+    }
+
+    QVERIFY(sum > 0);
+}
+
+void Benchmarks::simulate_data()
+{
+    addSimulatorRows();
+}
+
+void Benchmarks::simulate()
+{
+    QFETCH(int, simulator);
+
+    const QByteArray csv = TrackGenerator::generate(
+                TrackGenerator::Wingsuit, 5, 600, seed);
+
+    Track track;
+    track.parse(csv.constData(), csv.constData() + csv.size());
+    track.initialize(trackParameters(track));
+
+    const Optimizer::Parameters params =
+            optimizerParameters(track, (Optimizer::Simulator) simulator);
+
+    // Random candidates at an intermediate level of detail
+    const double dt = 0.25;
+    const int genomeSize = 513;         // 120 s at dt
+    const int k = 7;
+
+    RandomStream random(seed);
+    QVector< Genome > genomes;
+    for (int i = 0; i < numGenomes; ++i)
+    {
+        genomes.append(Genome(genomeSize, k, params.minLift, params.maxLift,
+                              random));
+    }
+
+    Trajectory trajectories[batchSize];
+    DistanceEvaluator evaluators[batchSize];
+    FitnessEvaluator *evaluatorPointers[batchSize];
+    for (int j = 0; j < batchSize; ++j)
+    {
+        evaluatorPointers[j] = &evaluators[j];
+    }
+
+    BatchSimulator batchSimulator;
+
+    double sum = 0;
+    QBENCHMARK
+    {
+        for (int i = 0; i < numGenomes; i += batchSize)
+        {
+            const Genome *batch[batchSize];
+            for (int j = 0; j < batchSize; ++j)
+            {
+                batch[j] = &genomes[i + j];
+            }
+
+            if (simulator == Optimizer::Batched)
+            {
+                batchSimulator.simulate(dt, params.a, params.c,
+                                        params.planformArea, params.mass,
+                                        params.dp0, params.windowBottom,
+                                        batch, batchSize,
+                                        trajectories, evaluatorPointers);
+            }
+            else
+            {
+                for (int j = 0; j < batchSize; ++j)
+                {
+                    batch[j]->simulate(dt, params.a, params.c,
+                                       params.planformArea, params.mass,
+                                       params.dp0, params.windowBottom,
+                                       trajectories[j], &evaluators[j]);
+                }
+            }
+
+            for (int j = 0; j < batchSize; ++j)
+            {
+                sum += evaluators[j].score();
+            }
+        }
+    }
+
+    QVERIFY(sum > 0);
+}
+
+void Benchmarks::optimize_data()
+{
+    addSimulatorRows();
+}
+
+void Benchmarks::optimize()
+{
+    QFETCH(int, simulator);
+
+    const QByteArray csv = TrackGenerator::generate(
+                TrackGenerator::Wingsuit, 5, 600, seed);
+
+    Track track;
+    track.parse(csv.constData(), csv.constData() + csv.size());
+    track.initialize(trackParameters(track));
+
+    const Optimizer::Parameters params =
+            optimizerParameters(track, (Optimizer::Simulator) simulator);
+
+    DistanceFunction function;
+    QVector< DataPoint > result;
+    QBENCHMARK
+    {
+        // Start every run without cached scores
+        function.fitnessCache()->clear();
+
+        GeneticOptimizer optimizer(&function, params);
+        result = optimizer.optimize();
+    }
+
+    QVERIFY(!result.isEmpty());
+}
@@ -0,0 +1,90 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+#include "track.h"
+
+// Timings for track import, kinematics, plotting, the map path, wind
+// fitting, scoring and optimization. Most benchmarks run on synthetic
+// tracks covering a range of profiles, sample rates and durations, which
+// are generated before timing starts.
+
+class Benchmarks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parse_data();
+    void parse();
+    void parseLegacy_data();
+    void parseLegacy();
+
+    void initialize_data();
+    void initialize();
+    void updateWind_data();
+    void updateWind();
+
+    void columns_data();
+    void columns();
+    void plotData_data();
+    void plotData();
+    void zoom_data();
+    void zoom();
+    void autoscale_data();
+    void autoscale();
+    void replot_data();
+    void replot();
+
+    void mapPath_data();
+    void mapPath();
+    void windFit_data();
+    void windFit();
+    void windowBounds_data();
+    void windowBounds();
+
+    void density_data();
+    void density();
+    void simulate_data();
+    void simulate();
+    void optimize_data();
+    void optimize();
+
+private:
+    QHash< QString, QByteArray > mTracks;
+
+    void addTrackRows();
+    void addSimulatorRows();
+
+    // Generated file and parsed track for the current row
+    QByteArray trackData();
+    Track initializedTrack();
+};
+
+#endif // BENCHMARKS_H
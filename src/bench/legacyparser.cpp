@@ -0,0 +1,111 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "legacyparser.h"
+
+#include <QIODevice>
+#include <QMap>
+#include <QStringList>
+#include <QTextStream>
+
+void LegacyParser::parse(
+        QIODevice *device,
+        QVector< DataPoint > &data)
+{
+    QTextStream in(device);
+
+    // Column enumeration
+    typedef enum {
+        Time = 0,
+        Lat,
+        Lon,
+        HMSL,
+        VelN,
+        VelE,
+        VelD,
+        HAcc,
+        VAcc,
+        SAcc,
+        Heading,
+        CAcc,
+        NumSV
+    } Columns;
+
+    // Read column labels
+    QMap< int, int > colMap;
+    if (!in.atEnd())
+    {
+        QString line = in.readLine();
+        QStringList cols = line.split(",");
+
+        for (int i = 0; i < cols.size(); ++i)
+        {
+            const QString &s = cols[i];
+
+            if (s == "time")    colMap[Time]    = i;
+            if (s == "lat")     colMap[Lat]     = i;
+            if (s == "lon")     colMap[Lon]     = i;
+            if (s == "hMSL")    colMap[HMSL]    = i;
+            if (s == "velN")    colMap[VelN]    = i;
+            if (s == "velE")    colMap[VelE]    = i;
+            if (s == "velD")    colMap[VelD]    = i;
+            if (s == "hAcc")    colMap[HAcc]    = i;
+            if (s == "vAcc")    colMap[VAcc]    = i;
+            if (s == "sAcc")    colMap[SAcc]    = i;
+            if (s == "numSV")   colMap[NumSV]   = i;
+        }
+    }
+
+    // Skip next row
+    if (!in.atEnd()) in.readLine();
+
+    data.clear();
+
+    while (!in.atEnd())
+    {
+        QString line = in.readLine();
+        QStringList cols = line.split(",");
+
+        DataPoint pt;
+
+        pt.dateTime = QDateTime::fromString(cols[colMap[Time]], Qt::ISODate);
+
+        pt.hasGeodetic = true;
+
+        pt.lat   = cols[colMap[Lat]].toDouble();
+        pt.lon   = cols[colMap[Lon]].toDouble();
+        pt.hMSL  = cols[colMap[HMSL]].toDouble();
+
+        pt.velN  = cols[colMap[VelN]].toDouble();
+        pt.velE  = cols[colMap[VelE]].toDouble();
+        pt.velD  = cols[colMap[VelD]].toDouble();
+
+        pt.hAcc  = cols[colMap[HAcc]].toDouble();
+        pt.vAcc  = cols[colMap[VAcc]].toDouble();
+        pt.sAcc  = cols[colMap[SAcc]].toDouble();
+
+        pt.numSV = cols[colMap[NumSV]].toDouble();
+
+        data.append(pt);
+    }
+}
@@ -0,0 +1,307 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackgenerator.h"
+
+#include <QDateTime>
+#include <QVector>
+
+#include <math.h>
+
+#include "randomstream.h"
+
+namespace
+{
+
+const double PI           = 3.14159265359;
+const double EARTH_RADIUS = 6371000;    // Mean radius (m)
+
+const double LAT0         = 51.05;      // Drop zone (deg)
+const double LON0         = -114.07;
+const double GROUND       = 1100;       // Ground elevation (m MSL)
+const qint64 START_TIME   = Q_INT64_C(1527872400000);   // 2018-06-01 17:00 UTC
+const double LANDED_TIME  = 30;         // Time recorded after landing (s)
+
+typedef enum {
+    Climb, Freefall, Canopy, Swoop, Flare, Landed
+} Phase;
+
+// Velocity approached during one phase of the jump
+typedef struct {
+    double velH;        // Horizontal speed (m/s)
+    double velD;        // Vertical speed, positive down (m/s)
+    double turnRate;    // deg/s
+    double tau;         // Time constant of approach to target (s)
+} Target;
+
+typedef struct {
+    double exitAltitude;    // Above ground (m)
+    double deployAltitude;
+    double swoopAltitude;   // Zero for no swoop
+    double flareAltitude;
+    Target targets[Landed + 1];
+} Jump;
+
+typedef struct {
+    double e, n, u;         // Position relative to the landing area (m)
+    double velE, velN, velD;
+} Sample;
+
+Jump jump(
+        TrackGenerator::Profile profile)
+{
+    const Target climb  = {40, -7, 1, 5};
+    const Target canopy = {10, 5, 2, 3};
+    const Target swoop  = {25, 15, 20, 2};
+    const Target flare  = {8, 1, 0, 1};
+    const Target ground = {0, 0, 0, 1};
+
+    Jump jump;
+
+    jump.exitAltitude = 4000;
+    jump.deployAltitude = 1000;
+    jump.swoopAltitude = 0;
+    jump.flareAltitude = 10;
+
+    jump.targets[Climb] = climb;
+    jump.targets[Canopy] = canopy;
+    jump.targets[Swoop] = swoop;
+    jump.targets[Flare] = flare;
+    jump.targets[Landed] = ground;
+
+    switch (profile)
+    {
+    case TrackGenerator::Wingsuit:
+    {
+        const Target freefall = {45, 22, 0, 6};
+        jump.targets[Freefall] = freefall;
+        break;
+    }
+    case TrackGenerator::Canopy:
+    {
+        // Hop and pop followed by a swoop
+        const Target freefall = {30, 10, 0, 2};
+        jump.targets[Freefall] = freefall;
+
+        jump.exitAltitude = 1500;
+        jump.deployAltitude = 1400;
+        jump.swoopAltitude = 300;
+        jump.flareAltitude = 30;
+        break;
+    }
+    default: // Skydive
+    {
+        const Target freefall = {5, 55, 0, 4};
+        jump.targets[Freefall] = freefall;
+        break;
+    }
+    }
+
+    return jump;
+}
+
+class Noise
+{
+public:
+    explicit Noise(quint64 seed): mRandom(seed) {}
+
+    // Normally distributed, using the Box-Muller transform
+    double gaussian(double sigma)
+    {
+        const double u1 = 1 - mRandom.uniform();
+        const double u2 = mRandom.uniform();
+        return sigma * sqrt(-2 * log(u1)) * cos(2 * PI * u2);
+    }
+
+    int bounded(int n) { return mRandom.bounded(n); }
+
+private:
+    RandomStream mRandom;
+};
+
+QVector< Sample > simulate(
+        const Jump &jump,
+        double dt,
+        Noise &noise)
+{
+    QVector< Sample > samples;
+
+    Sample s = {0, 0, 0, 0, 0, 0};
+    double heading = 0;
+    double landed = 0;
+
+    Phase phase = Climb;
+    while (landed < LANDED_TIME)
+    {
+        const Target &target = jump.targets[phase];
+        const double k = 1 - exp(-dt / target.tau);
+
+        heading += target.turnRate * dt / 180 * PI;
+
+        // Relax toward target velocity, with a little turbulence
+        const double turbulence = (phase == Landed) ? 0 : 0.3 * sqrt(dt);
+        s.velE += (target.velH * sin(heading) - s.velE) * k + noise.gaussian(turbulence);
+        s.velN += (target.velH * cos(heading) - s.velN) * k + noise.gaussian(turbulence);
+        s.velD += (target.velD - s.velD) * k + noise.gaussian(turbulence);
+
+        s.e += s.velE * dt;
+        s.n += s.velN * dt;
+        s.u -= s.velD * dt;
+
+        switch (phase)
+        {
+        case Climb:
+            if (s.u >= jump.exitAltitude) phase = Freefall;
+            break;
+        case Freefall:
+            if (s.u <= jump.deployAltitude) phase = Canopy;
+            break;
+        case Canopy:
+            if (s.u <= jump.swoopAltitude) phase = Swoop;
+            else if (s.u <= jump.flareAltitude) phase = Flare;
+            break;
+        case Swoop:
+            if (s.u <= jump.flareAltitude) phase = Flare;
+            break;
+        default:
+            break;
+        }
+
+        if (s.u <= 0 && phase != Climb)
+        {
+            s.u = 0;
+            s.velD = 0;
+            phase = Landed;
+        }
+
+        if (phase == Landed)
+        {
+            landed += dt;
+        }
+
+        samples.append(s);
+    }
+
+    return samples;
+}
+
+} // namespace
+
+QByteArray TrackGenerator::generate(
+        Profile profile,
+        double rate,
+        double duration,
+        quint64 seed)
+{
+    Noise noise(seed);
+
+    const double dt = 1 / rate;
+    const QVector< Sample > samples = simulate(jump(profile), dt, noise);
+
+    // Keep the end of the jump, waiting on the ground first if needed
+    const int count = qRound(duration * rate);
+    const int pad = qMax(0, count - samples.size());
+    const int first = samples.size() - (count - pad);
+
+    const Sample ground = {0, 0, 0, 0, 0, 0};
+
+    QByteArray out;
+    out.reserve(count * 128);
+
+    out.append("time,lat,lon,hMSL,velN,velE,velD,hAcc,vAcc,sAcc,heading,cAcc,gpsFix,numSV\n");
+    out.append(",(deg),(deg),(m),(m/s),(m/s),(m/s),(m),(m),(m/s),(deg),(deg),,\n");
+
+    const double metersToLat = 180 / PI / EARTH_RADIUS;
+    const double metersToLon = metersToLat / cos(LAT0 / 180 * PI);
+
+    QByteArray date;
+    qint64 day = -1;
+
+    char buffer[256];
+    for (int i = 0; i < count; ++i)
+    {
+        const Sample &s = (i < pad) ? ground : samples[first + i - pad];
+
+        const qint64 ms = START_TIME + qRound64(i * 1000 / rate);
+        if (ms / 86400000 != day)
+        {
+            day = ms / 86400000;
+            date = QDateTime::fromMSecsSinceEpoch(ms, Qt::UTC)
+                    .toString("yyyy-MM-dd").toLatin1();
+        }
+
+        const int msOfDay = (int) (ms % 86400000);
+
+        // Measurement noise
+        const double e = s.e + noise.gaussian(0.3);
+        const double n = s.n + noise.gaussian(0.3);
+        const double u = s.u + noise.gaussian(0.5);
+
+        const double velN = s.velN + noise.gaussian(0.1);
+        const double velE = s.velE + noise.gaussian(0.1);
+        const double velD = s.velD + noise.gaussian(0.1);
+
+        double heading = atan2(velE, velN) / PI * 180;
+        if (heading < 0) heading += 360;
+
+        const int length = qsnprintf(
+                    buffer, sizeof(buffer),
+                    "%sT%02d:%02d:%02d.%03dZ,%.7f,%.7f,%.3f,%.2f,%.2f,%.2f,"
+                    "%.3f,%.3f,%.2f,%.5f,%.5f,3,%d\n",
+                    date.constData(),
+                    msOfDay / 3600000,
+                    msOfDay / 60000 % 60,
+                    msOfDay / 1000 % 60,
+                    msOfDay % 1000,
+                    LAT0 + n * metersToLat,
+                    LON0 + e * metersToLon,
+                    GROUND + u,
+                    velN,
+                    velE,
+                    velD,
+                    2 + fabs(noise.gaussian(1)),
+                    3 + fabs(noise.gaussian(2)),
+                    0.3 + fabs(noise.gaussian(0.2)),
+                    heading,
+                    1 + fabs(noise.gaussian(0.5)),
+                    10 + noise.bounded(6));
+
+        out.append(buffer, length);
+    }
+
+    return out;
+}
+
+QString TrackGenerator::profileName(
+        Profile profile)
+{
+    switch (profile)
+    {
+    case Wingsuit:
+        return QString("wingsuit");
+    case Canopy:
+        return QString("canopy");
+    default: // Skydive
+        return QString("skydive");
+    }
+}
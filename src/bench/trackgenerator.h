@@ -0,0 +1,48 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKGENERATOR_H
+#define TRACKGENERATOR_H
+
+#include <QByteArray>
+#include <QString>
+
+// Synthetic FlySight tracks for benchmarking. A jump is simulated with
+// simple kinematics and sensor noise, and the recording is padded with
+// time on the ground before the climb, so any duration can be generated
+// with the jump at its end. The same seed always gives the same file.
+
+namespace TrackGenerator
+{
+    typedef enum {
+        Skydive, Wingsuit, Canopy
+    } Profile;
+
+    // FlySight CSV sampled at rate (Hz) covering duration (s)
+    QByteArray generate(Profile profile, double rate, double duration,
+                        quint64 seed);
+
+    QString profileName(Profile profile);
+}
+
+#endif // TRACKGENERATOR_H
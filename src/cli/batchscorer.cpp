@@ -0,0 +1,147 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "batchscorer.h"
+
+#include <QtNumeric>
+
+#include "kinematics.h"
+#include "track.h"
+
+namespace
+{
+
+QString statusText(
+        ScoringRules::Status status)
+{
+    switch (status)
+    {
+    case ScoringRules::Scored:
+        return "ok";
+    case ScoringRules::NoData:
+        return "no-data";
+    case ScoringRules::SetExit:
+        return "low-exit";
+    case ScoringRules::SetReference:
+        return "far-from-lane";
+    case ScoringRules::IncompleteData:
+        return "incomplete";
+    default: // DidNotFinish
+        return "dnf";
+    }
+}
+
+} // namespace
+
+BatchScorer::Task::Task(
+        const Settings &settings):
+    mSettings(settings)
+{
+
+}
+
+BatchScorer::Result BatchScorer::Task::operator()(
+        const QString &fileName) const
+{
+    Result result;
+    result.fileName = fileName;
+    result.scored = false;
+    result.ground = qQNaN();
+    result.time = qQNaN();
+    result.distance = qQNaN();
+    result.speed = qQNaN();
+
+    // Parse track data
+    Track track;
+    if (!track.load(fileName))
+    {
+        result.status = "unreadable";
+        return result;
+    }
+
+    if (track.isEmpty())
+    {
+        result.status = statusText(ScoringRules::NoData);
+        return result;
+    }
+
+    // Derive remaining channels
+    Kinematics::Parameters params = track.parameters();
+    params.exit = Kinematics::findExit(track.data(), mSettings.exitSpeed);
+    params.ground = mSettings.automaticGround ? track.last().hMSL
+                                              : mSettings.ground;
+    track.initialize(params);
+
+    const Track::DataPoints &data = track.data();
+
+    result.exit = QDateTime::fromMSecsSinceEpoch(params.exit, Qt::UTC);
+    result.ground = params.ground;
+
+    ScoringRules::Status status;
+    DataPoint dpBottom, dpTop, dpFinish;
+    bool hasFinish;
+
+    switch (mSettings.rules)
+    {
+    case PPC:
+        if (ScoringRules::windowBounds(data, mSettings.windowTop, mSettings.windowBottom, dpBottom, dpTop))
+        {
+            result.time = ScoringRules::ppcTime(dpTop, dpBottom);
+            result.distance = ScoringRules::ppcDistance(dpTop, dpBottom);
+            result.speed = ScoringRules::ppcSpeed(dpTop, dpBottom);
+            status = ScoringRules::Scored;
+        }
+        else
+        {
+            status = ScoringRules::IncompleteData;
+        }
+        break;
+    case Speed:
+        if (ScoringRules::windowBounds(data, mSettings.windowTop, mSettings.windowBottom, dpBottom, dpTop))
+        {
+            result.speed = ScoringRules::speed(mSettings.windowTop, mSettings.windowBottom, dpTop, dpBottom);
+            status = ScoringRules::Scored;
+        }
+        else
+        {
+            status = ScoringRules::IncompleteData;
+        }
+        break;
+    case WideOpenDistance:
+        status = ScoringRules::wideOpenDistance(data, mSettings.lane, result.distance);
+        break;
+    default: // WideOpenSpeed
+        status = ScoringRules::wideOpenSpeed(data, mSettings.lane, dpFinish, hasFinish);
+        if (status == ScoringRules::Scored)
+        {
+            result.time = dpFinish.t;
+            result.finish = dpFinish.dateTime.toUTC();
+        }
+        break;
+    }
+
+    result.scored = (status == ScoringRules::Scored);
+    result.status = statusText(status);
+
+    return result;
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef BATCHSCORER_H
+#define BATCHSCORER_H
+
+#include <QDateTime>
+#include <QString>
+
+#include "scoringrules.h"
+
+namespace BatchScorer
+{
+    typedef enum {
+        PPC, Speed, WideOpenDistance, WideOpenSpeed
+    } Rules;
+
+    typedef struct {
+        Rules              rules;
+        double             windowTop;       // PPC and Speed (m)
+        double             windowBottom;
+        ScoringRules::Lane lane;            // Wide Open
+        bool               automaticGround;
+        double             ground;          // Fixed ground elevation (m)
+        double             exitSpeed;       // Vertical speed at exit (m/s)
+    } Settings;
+
+    typedef struct {
+        QString   fileName;
+        QString   status;
+        bool      scored;
+        QDateTime exit;
+        double    ground;
+        double    time;                     // PPC, Wide Open Speed (s)
+        double    distance;                 // PPC, Wide Open Distance (m)
+        double    speed;                    // PPC, Speed (m/s)
+        QDateTime finish;                   // Wide Open Speed
+    } Result;
+
+    // Parses, derives and scores one file; safe to run on any thread
+    class Task
+    {
+    public:
+        typedef Result result_type;
+
+        explicit Task(const Settings &settings);
+
+        Result operator()(const QString &fileName) const;
+
+    private:
+        Settings mSettings;
+    };
+}
+
+#endif // BATCHSCORER_H
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Headless batch scoring tool
+#
+#-------------------------------------------------
+
+QT       += core concurrent
+QT       -= gui
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x000000
+
+TARGET = FlySightScore
+TEMPLATE = app
+
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += main.cpp \
+    batchscorer.cpp
+
+HEADERS  += batchscorer.h
+
+include(../core/core.pri)
@@ -0,0 +1,357 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <stdio.h>
+
+#include "batchscorer.h"
+
+namespace
+{
+
+bool parseRules(
+        const QString &name,
+        BatchScorer::Rules &rules)
+{
+    if      (name == "ppc")               rules = BatchScorer::PPC;
+    else if (name == "speed")             rules = BatchScorer::Speed;
+    else if (name == "wideopen-distance") rules = BatchScorer::WideOpenDistance;
+    else if (name == "wideopen-speed")    rules = BatchScorer::WideOpenSpeed;
+    else return false;
+
+    return true;
+}
+
+bool parseValue(
+        const QCommandLineParser &parser,
+        const QString &name,
+        double &value)
+{
+    // Options without a default keep the value given
+    const QString text = parser.value(name);
+    if (text.isEmpty()) return true;
+
+    bool ok;
+    value = text.toDouble(&ok);
+    return ok;
+}
+
+QStringList findTracks(
+        const QStringList &paths,
+        bool recursive)
+{
+    QStringList fileNames;
+
+    foreach (QString path, paths)
+    {
+        if (QFileInfo(path).isDir())
+        {
+            QStringList found;
+            QDirIterator it(path, QStringList("*.csv"), QDir::Files,
+                            recursive ? QDirIterator::Subdirectories
+                                      : QDirIterator::NoIteratorFlags);
+            while (it.hasNext())
+            {
+                found.append(it.next());
+            }
+
+            // Keep output in a stable order
+            found.sort();
+            fileNames.append(found);
+        }
+        else
+        {
+            fileNames.append(path);
+        }
+    }
+
+    return fileNames;
+}
+
+QString number(
+        double value,
+        int precision)
+{
+    return qIsNaN(value) ? QString() : QString::number(value, 'f', precision);
+}
+
+QString quoted(
+        const QString &text)
+{
+    QString result = text;
+    result.replace("\"", "\"\"");
+    return "\"" + result + "\"";
+}
+
+void writeCsv(
+        QTextStream &out,
+        BatchScorer::Rules rules,
+        const QList< BatchScorer::Result > &results)
+{
+    out << "file,status,exit,ground";
+    switch (rules)
+    {
+    case BatchScorer::PPC:
+        out << ",time,distance,speed";
+        break;
+    case BatchScorer::Speed:
+        out << ",speed";
+        break;
+    case BatchScorer::WideOpenDistance:
+        out << ",distance";
+        break;
+    case BatchScorer::WideOpenSpeed:
+        out << ",finish,time";
+        break;
+    }
+    out << "\n";
+
+    foreach (const BatchScorer::Result &result, results)
+    {
+        out << quoted(result.fileName) << ","
+            << result.status << ","
+            << result.exit.toString(Qt::ISODate) << ","
+            << number(result.ground, 3);
+
+        switch (rules)
+        {
+        case BatchScorer::PPC:
+            out << "," << number(result.time, 3)
+                << "," << number(result.distance, 3)
+                << "," << number(result.speed, 3);
+            break;
+        case BatchScorer::Speed:
+            out << "," << number(result.speed, 3);
+            break;
+        case BatchScorer::WideOpenDistance:
+            out << "," << number(result.distance, 3);
+            break;
+        case BatchScorer::WideOpenSpeed:
+            out << "," << result.finish.toString("yyyy-MM-ddThh:mm:ss.zzzZ")
+                << "," << number(result.time, 3);
+            break;
+        }
+        out << "\n";
+    }
+}
+
+void writeJson(
+        QTextStream &out,
+        BatchScorer::Rules rules,
+        const QList< BatchScorer::Result > &results)
+{
+    QJsonArray array;
+
+    foreach (const BatchScorer::Result &result, results)
+    {
+        QJsonObject object;
+        object["file"] = result.fileName;
+        object["status"] = result.status;
+
+        if (result.exit.isValid())
+        {
+            object["exit"] = result.exit.toString(Qt::ISODate);
+            object["ground"] = result.ground;
+        }
+
+        if (result.scored)
+        {
+            switch (rules)
+            {
+            case BatchScorer::PPC:
+                object["time"] = result.time;
+                object["distance"] = result.distance;
+                object["speed"] = result.speed;
+                break;
+            case BatchScorer::Speed:
+                object["speed"] = result.speed;
+                break;
+            case BatchScorer::WideOpenDistance:
+                object["distance"] = result.distance;
+                break;
+            case BatchScorer::WideOpenSpeed:
+                object["finish"] = result.finish.toString("yyyy-MM-ddThh:mm:ss.zzzZ");
+                object["time"] = result.time;
+                break;
+            }
+        }
+
+        array.append(object);
+    }
+
+    out << QJsonDocument(array).toJson();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("FlySightScore");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "Scores FlySight tracks without a display. Distances are in "
+                "metres, times in seconds and speeds in metres per second.");
+    parser.addHelpOption();
+
+    parser.addPositionalArgument("rules", "ppc, speed, wideopen-distance or wideopen-speed");
+    parser.addPositionalArgument("paths", "Track files or directories of tracks", "paths...");
+
+    parser.addOptions(QList< QCommandLineOption >()
+        << QCommandLineOption("top", "Top of scoring window above ground (PPC default 3000, Speed default 2700).", "m")
+        << QCommandLineOption("bottom", "Bottom of scoring window or lane above ground (PPC default 2000, Speed default 1700, Wide Open default 1371.6).", "m")
+        << QCommandLineOption("end-lat", "Latitude of the end of the lane.", "deg")
+        << QCommandLineOption("end-lon", "Longitude of the end of the lane.", "deg")
+        << QCommandLineOption("bearing", "Bearing from the end of the lane to its start.", "deg", "0")
+        << QCommandLineOption("lane-width", "Width of the lane.", "m", "500")
+        << QCommandLineOption("lane-length", "Length of the lane.", "m", "10000")
+        << QCommandLineOption("ground", "Fixed ground elevation above mean sea level. By default the last point of each track is used.", "m")
+        << QCommandLineOption("exit-speed", "Vertical speed which marks exit.", "m/s", "10")
+        << QCommandLineOption(QStringList() << "f" << "format", "Output format, csv or json.", "format", "csv")
+        << QCommandLineOption(QStringList() << "o" << "output", "Output file. By default results are written to standard output.", "file")
+        << QCommandLineOption(QStringList() << "r" << "recursive", "Search directories recursively.")
+        << QCommandLineOption(QStringList() << "j" << "jobs", "Number of tracks to score at once. By default all cores are used.", "count"));
+
+    parser.process(app);
+
+    QTextStream err(stderr);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() < 2)
+    {
+        parser.showHelp(1);
+    }
+
+    // Scoring settings
+    BatchScorer::Settings settings;
+    if (!parseRules(args[0], settings.rules))
+    {
+        err << "Unknown rules: " << args[0] << "\n";
+        return 1;
+    }
+
+    if (settings.rules == BatchScorer::PPC)
+    {
+        settings.windowTop = 3000;
+        settings.windowBottom = 2000;
+    }
+    else
+    {
+        settings.windowTop = 2700;
+        settings.windowBottom = 1700;
+    }
+
+    settings.lane.endLatitude = 0;
+    settings.lane.endLongitude = 0;
+    settings.lane.bearing = 0;
+    settings.lane.bottom = 1371.6;     // 4500 ft
+    settings.lane.laneWidth = 0;
+    settings.lane.laneLength = 0;
+
+    settings.automaticGround = !parser.isSet("ground");
+    settings.ground = 0;
+    settings.exitSpeed = 0;
+
+    const bool wideOpen = (settings.rules == BatchScorer::WideOpenDistance
+                           || settings.rules == BatchScorer::WideOpenSpeed);
+
+    if (wideOpen && !(parser.isSet("end-lat") && parser.isSet("end-lon")))
+    {
+        err << "Wide Open rules require --end-lat and --end-lon\n";
+        return 1;
+    }
+
+    if (!parseValue(parser, "top", settings.windowTop)
+            || !parseValue(parser, "bottom", wideOpen ? settings.lane.bottom : settings.windowBottom)
+            || !parseValue(parser, "end-lat", settings.lane.endLatitude)
+            || !parseValue(parser, "end-lon", settings.lane.endLongitude)
+            || !parseValue(parser, "bearing", settings.lane.bearing)
+            || !parseValue(parser, "lane-width", settings.lane.laneWidth)
+            || !parseValue(parser, "lane-length", settings.lane.laneLength)
+            || !parseValue(parser, "ground", settings.ground)
+            || !parseValue(parser, "exit-speed", settings.exitSpeed))
+    {
+        err << "Invalid numeric option\n";
+        return 1;
+    }
+
+    const QString format = parser.value("format");
+    if (format != "csv" && format != "json")
+    {
+        err << "Unknown format: " << format << "\n";
+        return 1;
+    }
+
+    if (parser.isSet("jobs"))
+    {
+        const int jobs = parser.value("jobs").toInt();
+        if (jobs < 1)
+        {
+            err << "Invalid number of jobs\n";
+            return 1;
+        }
+
+        QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    }
+
+    // Score tracks in parallel
+    const QStringList fileNames = findTracks(args.mid(1), parser.isSet("recursive"));
+    const QList< BatchScorer::Result > results =
+            QtConcurrent::blockingMapped< QList< BatchScorer::Result > >(
+                fileNames, BatchScorer::Task(settings));
+
+    // Write results
+    QFile file;
+    if (parser.isSet("output"))
+    {
+        file.setFileName(parser.value("output"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        {
+            err << "Couldn't write " << parser.value("output") << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        file.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+
+    QTextStream out(&file);
+    if (format == "csv") writeCsv(out, settings.rules, results);
+    else                 writeJson(out, settings.rules, results);
+
+    return 0;
+}
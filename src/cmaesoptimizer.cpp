@@ -0,0 +1,248 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "cmaesoptimizer.h"
+
+namespace
+{
+
+const int    maxEvaluations = 75000;    // Budget across all levels of detail
+const double initialSigma   = 0.3;      // Step size, relative to lift range
+const double refineSigma    = 0.05;     // Step size after refining
+const double tolX           = 1e-4;     // Smallest step, relative to lift range
+
+double gaussian(
+        RandomStream &random)
+{
+    // Box-Muller transform
+    const double u1 = 1 - random.uniform();
+    const double u2 = random.uniform();
+    return sqrt(-2 * log(u1)) * cos(2 * PI * u2);
+}
+
+} // namespace
+
+CmaesOptimizer::CmaesOptimizer(
+        FitnessFunction *function,
+        const Parameters &params,
+        QObject *parent):
+    Optimizer(function, params, parent)
+{
+
+}
+
+QVector< DataPoint > CmaesOptimizer::optimize()
+{
+    start();
+
+    const double range = mParams.maxLift - mParams.minLift;
+    const int levelBudget = maxEvaluations / (mKMax - mKMin + 1);
+
+    // Start in the middle of the allowed range
+    QVector< double > knots((1 << mKMin) + 1, (mParams.minLift + mParams.maxLift) / 2);
+
+    GenePool genePool;
+    genePool.append(Score(0, Genome(mGenomeSize, knots)));
+
+    evaluate(genePool);
+    setBestScore(genePool);
+    addProgress(1);
+
+    Score best = genePool[0];
+
+    int generation = 0;
+
+    // Increasing levels of detail
+    for (int k = mKMin; k <= mKMax && !isCanceled(); ++k)
+    {
+        const double sigma = (k == mKMin) ? initialSigma : refineSigma;
+        const int used = optimizeLevel(k, sigma * range, levelBudget,
+                                       generation, best);
+
+        // Skip whatever is left of this level
+        addProgress(levelBudget - used);
+    }
+
+    return simulate(best.second);
+}
+
+int CmaesOptimizer::progressMaximum() const
+{
+    return 1 + (maxEvaluations / (mKMax - mKMin + 1)) * (mKMax - mKMin + 1);
+}
+
+int CmaesOptimizer::optimizeLevel(
+        int k,
+        double sigma,
+        int budget,
+        int &generation,
+        Score &best)
+{
+    const double range = mParams.maxLift - mParams.minLift;
+
+    // Start from the best schedule so far
+    QVector< double > mean = best.second.knots(k);
+
+    const int n = mean.size();
+    const int lambda = 4 + (int) (3 * log((double) n));
+    const int mu = lambda / 2;
+
+    // Recombination weights
+    QVector< double > weights(mu);
+    double sumWeights = 0;
+    for (int i = 0; i < mu; ++i)
+    {
+        weights[i] = log(mu + 0.5) - log(i + 1.0);
+        sumWeights += weights[i];
+    }
+
+    double sumSquares = 0;
+    for (int i = 0; i < mu; ++i)
+    {
+        weights[i] /= sumWeights;
+        sumSquares += weights[i] * weights[i];
+    }
+
+    const double mueff = 1 / sumSquares;
+
+    // Adaptation constants, with learning rates for the separable variant
+    const double cs = (mueff + 2) / (n + mueff + 5);
+    const double ds = 1 + 2 * qMax(0.0, sqrt((mueff - 1) / (n + 1)) - 1) + cs;
+    const double cc = (4 + mueff / n) / (n + 4 + 2 * mueff / n);
+    const double c1 = qMin(1.0, 2 / ((n + 1.3) * (n + 1.3) + mueff) * (n + 2) / 3);
+    const double cmu = qMin(1 - c1, 2 * (mueff - 2 + 1 / mueff) / ((n + 2) * (n + 2) + mueff) * (n + 2) / 3);
+    const double chiN = sqrt((double) n) * (1 - 1.0 / (4 * n) + 1.0 / (21.0 * n * n));
+
+    QVector< double > diagC(n, 1), ps(n, 0), pc(n, 0);
+    QVector< double > steps(lambda * n);
+    QVector< double > yw(n);
+
+    double levelBest = best.first;
+    int stall = 0;
+    int used = 0;
+
+    for (int g = 0; used + lambda <= budget && !isCanceled(); ++g)
+    {
+        // Sample new individuals, keeping them within bounds
+        GenePool genePool;
+        for (int i = 0; i < lambda; ++i)
+        {
+            RandomStream random(mParams.seed, generation, i);
+
+            QVector< double > x(n);
+            for (int j = 0; j < n; ++j)
+            {
+                const double z = gaussian(random);
+                x[j] = qBound(mParams.minLift,
+                              mean[j] + sigma * sqrt(diagC[j]) * z,
+                              mParams.maxLift);
+                steps[i * n + j] = (x[j] - mean[j]) / sigma;
+            }
+
+            genePool.append(Score(0, Genome(mGenomeSize, x)));
+        }
+        ++generation;
+
+        evaluate(genePool);
+        setBestScore(genePool);
+
+        used += lambda;
+        addProgress(lambda);
+
+        // Rank by score
+        QVector< QPair< double, int > > ranks;
+        for (int i = 0; i < lambda; ++i)
+        {
+            ranks.append(QPair< double, int >(-genePool[i].first, i));
+        }
+        qSort(ranks);
+
+        const Score &top = genePool[ranks[0].second];
+        if (top.first > best.first)
+        {
+            best = top;
+        }
+
+        if (top.first > levelBest)
+        {
+            levelBest = top.first;
+            stall = 0;
+        }
+        else
+        {
+            ++stall;
+        }
+
+        // Update mean
+        for (int j = 0; j < n; ++j)
+        {
+            yw[j] = 0;
+            for (int i = 0; i < mu; ++i)
+            {
+                yw[j] += weights[i] * steps[ranks[i].second * n + j];
+            }
+            mean[j] += sigma * yw[j];
+        }
+
+        // Update evolution paths
+        double psNorm = 0;
+        for (int j = 0; j < n; ++j)
+        {
+            ps[j] = (1 - cs) * ps[j] + sqrt(cs * (2 - cs) * mueff) * yw[j] / sqrt(diagC[j]);
+            psNorm += ps[j] * ps[j];
+        }
+        psNorm = sqrt(psNorm);
+
+        const bool hsig = psNorm / sqrt(1 - pow(1 - cs, 2 * (g + 1))) / chiN < 1.4 + 2.0 / (n + 1);
+
+        for (int j = 0; j < n; ++j)
+        {
+            pc[j] = (1 - cc) * pc[j] + (hsig ? sqrt(cc * (2 - cc) * mueff) * yw[j] : 0);
+        }
+
+        // Update covariance and step size
+        double maxC = 0;
+        for (int j = 0; j < n; ++j)
+        {
+            double rankMu = 0;
+            for (int i = 0; i < mu; ++i)
+            {
+                const double y = steps[ranks[i].second * n + j];
+                rankMu += weights[i] * y * y;
+            }
+
+            diagC[j] = (1 - c1 - cmu) * diagC[j]
+                    + c1 * (pc[j] * pc[j] + (hsig ? 0 : cc * (2 - cc) * diagC[j]))
+                    + cmu * rankMu;
+            maxC = qMax(maxC, diagC[j]);
+        }
+
+        sigma *= exp((cs / ds) * (psNorm / chiN - 1));
+
+        // Stop when steps are negligible or the best score stops improving
+        if (sigma * sqrt(maxC) < tolX * range) break;
+        if (stall > 10 + 30 * n / lambda) break;
+    }
+
+    return used;
+}
@@ -0,0 +1,50 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef CMAESOPTIMIZER_H
+#define CMAESOPTIMIZER_H
+
+#include "optimizer.h"
+
+// Covariance matrix adaptation evolution strategy over the knots of the
+// lift coefficient schedule. Uses the separable (diagonal) variant, which
+// costs O(n) per sample, and refines the schedule from coarse to fine like
+// the genetic optimizer. See Hansen, "The CMA Evolution Strategy: A
+// Tutorial", and Ros and Hansen, "A Simple Modification in CMA-ES
+// Achieving Linear Time and Space Complexity".
+
+class CmaesOptimizer : public Optimizer
+{
+public:
+    CmaesOptimizer(FitnessFunction *function, const Parameters &params,
+                   QObject *parent = 0);
+
+    QVector< DataPoint > optimize();
+    int progressMaximum() const;
+
+private:
+    int optimizeLevel(int k, double sigma, int budget, int &generation,
+                      Score &best);
+};
+
+#endif // CMAESOPTIMIZER_H
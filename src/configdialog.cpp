@@ -62,6 +62,10 @@ ConfigDialog::ConfigDialog(MainWindow *mainWindow) :
     ui->unitsCombo->addItems(
                 QStringList() << tr("Metric") << tr("Imperial"));
 
+    // Add optimization algorithms
+    ui->optimizerCombo->addItems(
+                QStringList() << tr("Genetic algorithm") << tr("CMA-ES") << tr("Gradient ascent"));
+
     // Update plot widget
     updatePlots();
 
@@ -268,6 +272,17 @@ double ConfigDialog::planformArea() const
     return ui->areaEdit->text().toDouble();
 }
 
+void ConfigDialog::setSlopeWindow(
+        int slopeWindow)
+{
+    ui->slopeWindowSpinBox->setValue(slopeWindow);
+}
+
+int ConfigDialog::slopeWindow() const
+{
+    return ui->slopeWindowSpinBox->value();
+}
+
 void ConfigDialog::setMinDrag(
         double minDrag)
 {
@@ -323,6 +338,28 @@ int ConfigDialog::simulationTime() const
     return ui->simTimeSpinBox->value();
 }
 
+void ConfigDialog::setBatchSimulation(
+        bool batchSimulation)
+{
+    ui->batchSimulationCheckBox->setChecked(batchSimulation);
+}
+
+bool ConfigDialog::batchSimulation() const
+{
+    return ui->batchSimulationCheckBox->isChecked();
+}
+
+void ConfigDialog::setOptimizationAlgorithm(
+        MainWindow::OptimizationAlgorithm algorithm)
+{
+    ui->optimizerCombo->setCurrentIndex(algorithm);
+}
+
+MainWindow::OptimizationAlgorithm ConfigDialog::optimizationAlgorithm() const
+{
+    return (MainWindow::OptimizationAlgorithm) ui->optimizerCombo->currentIndex();
+}
+
 QColor ConfigDialog::plotColor(
         int i) const
 {
@@ -404,3 +441,14 @@ QString ConfigDialog::databasePath() const
 {
     return ui->logbookFolderEdit->text();
 }
+
+void ConfigDialog::setTrackCacheSize(
+        int size)
+{
+    ui->trackCacheSpinBox->setValue(size);
+}
+
+int ConfigDialog::trackCacheSize() const
+{
+    return ui->trackCacheSpinBox->value();
+}
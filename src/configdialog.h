@@ -60,6 +60,9 @@ public:
     void setPlanformArea(double area);
     double planformArea() const;
 
+    void setSlopeWindow(int slopeWindow);
+    int slopeWindow() const;
+
     void setMinDrag(double minDrag);
     double minDrag() const;
 
@@ -75,6 +78,12 @@ public:
     void setSimulationTime(int simulationTime);
     int simulationTime() const;
 
+    void setBatchSimulation(bool batchSimulation);
+    bool batchSimulation() const;
+
+    void setOptimizationAlgorithm(MainWindow::OptimizationAlgorithm algorithm);
+    MainWindow::OptimizationAlgorithm optimizationAlgorithm() const;
+
     QColor plotColor(int i) const;
 
     double plotMinimum(int i) const;
@@ -97,6 +106,9 @@ public:
     void setDatabasePath(QString databasePath);
     QString databasePath() const;
 
+    void setTrackCacheSize(int size);
+    int trackCacheSize() const;
+
 private:
     Ui::ConfigDialog *ui;
 
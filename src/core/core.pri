@@ -0,0 +1,18 @@
+# Links a project against the flysight-core static library
+
+QT += concurrent
+
+INCLUDEPATH += $$PWD/..
+INCLUDEPATH += $$PWD/../../include
+INCLUDEPATH += $$PWD/../../include/GeographicLib
+
+# Build directory of the library, relative to the including project
+CORE_OUT = $$OUT_PWD/$$relative_path($$PWD, $$_PRO_FILE_PWD_)
+
+win32:CONFIG(release, debug|release): CORE_OUT = $$CORE_OUT/release
+else:win32:CONFIG(debug, debug|release): CORE_OUT = $$CORE_OUT/debug
+
+LIBS += -L$$CORE_OUT -lflysight-core
+
+win32-g++|!win32: PRE_TARGETDEPS += $$CORE_OUT/libflysight-core.a
+else: PRE_TARGETDEPS += $$CORE_OUT/flysight-core.lib
@@ -0,0 +1,110 @@
+#-------------------------------------------------
+#
+# Track parsing, kinematics, scoring rules, simulation and optimization
+# without any widgets, shared by the viewer and command-line tools
+#
+#-------------------------------------------------
+
+QT       += core concurrent
+QT       -= gui
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x000000
+
+TARGET = flysight-core
+TEMPLATE = lib
+CONFIG += staticlib
+
+SOURCES += ../atmosphere.cpp \
+    ../batchsimulator.cpp \
+    ../cmaesoptimizer.cpp \
+    ../datapoint.cpp \
+    ../fitnesscache.cpp \
+    ../fitnessevaluator.cpp \
+    ../geneticoptimizer.cpp \
+    ../genome.cpp \
+    ../geographicutil.cpp \
+    ../gradientoptimizer.cpp \
+    ../kinematics.cpp \
+    ../mappath.cpp \
+    ../minmaxpyramid.cpp \
+    ../optimizer.cpp \
+    ../prefixintegral.cpp \
+    ../profiler.cpp \
+    ../scoringrules.cpp \
+    ../track.cpp \
+    ../trackcache.cpp \
+    ../trackdata.cpp \
+    ../trackimport.cpp \
+    ../trackparser.cpp \
+    ../trackstore.cpp \
+    ../trajectory.cpp \
+    ../GeographicLib/Accumulator.cpp \
+    ../GeographicLib/AlbersEqualArea.cpp \
+    ../GeographicLib/AzimuthalEquidistant.cpp \
+    ../GeographicLib/CassiniSoldner.cpp \
+    ../GeographicLib/CircularEngine.cpp \
+    ../GeographicLib/DMS.cpp \
+    ../GeographicLib/Ellipsoid.cpp \
+    ../GeographicLib/EllipticFunction.cpp \
+    ../GeographicLib/GARS.cpp \
+    ../GeographicLib/Geocentric.cpp \
+    ../GeographicLib/GeoCoords.cpp \
+    ../GeographicLib/Geodesic.cpp \
+    ../GeographicLib/GeodesicExact.cpp \
+    ../GeographicLib/GeodesicExactC4.cpp \
+    ../GeographicLib/GeodesicLine.cpp \
+    ../GeographicLib/GeodesicLineExact.cpp \
+    ../GeographicLib/Geohash.cpp \
+    ../GeographicLib/Geoid.cpp \
+    ../GeographicLib/Georef.cpp \
+    ../GeographicLib/Gnomonic.cpp \
+    ../GeographicLib/GravityCircle.cpp \
+    ../GeographicLib/GravityModel.cpp \
+    ../GeographicLib/LambertConformalConic.cpp \
+    ../GeographicLib/LocalCartesian.cpp \
+    ../GeographicLib/MagneticCircle.cpp \
+    ../GeographicLib/MagneticModel.cpp \
+    ../GeographicLib/Math.cpp \
+    ../GeographicLib/MGRS.cpp \
+    ../GeographicLib/NormalGravity.cpp \
+    ../GeographicLib/OSGB.cpp \
+    ../GeographicLib/PolarStereographic.cpp \
+    ../GeographicLib/PolygonArea.cpp \
+    ../GeographicLib/Rhumb.cpp \
+    ../GeographicLib/SphericalEngine.cpp \
+    ../GeographicLib/TransverseMercator.cpp \
+    ../GeographicLib/TransverseMercatorExact.cpp \
+    ../GeographicLib/Utility.cpp \
+    ../GeographicLib/UTMUPS.cpp
+
+HEADERS  += ../atmosphere.h \
+    ../batchsimulator.h \
+    ../cmaesoptimizer.h \
+    ../common.h \
+    ../datapoint.h \
+    ../fitnesscache.h \
+    ../fitnessevaluator.h \
+    ../fitnessfunction.h \
+    ../geneticoptimizer.h \
+    ../genome.h \
+    ../geographicutil.h \
+    ../gradientoptimizer.h \
+    ../kinematics.h \
+    ../mappath.h \
+    ../minmaxpyramid.h \
+    ../optimizer.h \
+    ../prefixintegral.h \
+    ../profiler.h \
+    ../randomstream.h \
+    ../scoringrules.h \
+    ../track.h \
+    ../trackcache.h \
+    ../trackdata.h \
+    ../trackimport.h \
+    ../trackparser.h \
+    ../trackstore.h \
+    ../trajectory.h
+
+INCLUDEPATH += ..
+INCLUDEPATH += ../../include
+INCLUDEPATH += ../../include/GeographicLib
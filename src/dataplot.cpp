@@ -25,13 +25,16 @@
 
 #include "dataplot.h"
 #include "mainwindow.h"
+#include "profiler.h"
 
 DataPlot::DataPlot(QWidget *parent) :
     QCustomPlot(parent),
     mMainWindow(0),
     m_dragging(false),
     m_xAxisType(Time),
-    m_cursorValid(false)
+    m_cursorValid(false),
+    mAnnotationGraphsUsed(0),
+    mAnnotationRectsUsed(0)
 {
     // Initialize window
     setMouseTracking(true);
@@ -102,6 +105,37 @@ void DataPlot::initPlot()
     {
         v->readSettings();
     }
+
+    // Label to indicate wind correction, above the series
+    mWindLabel = new QCPItemText(this);
+    mWindLabel->setLayer("legend");
+    mWindLabel->setPositionAlignment(Qt::AlignTop|Qt::AlignRight);
+    mWindLabel->setTextAlignment(Qt::AlignRight);
+    mWindLabel->position->setType(QCPItemPosition::ptAxisRectRatio);
+    mWindLabel->position->setCoords(1, 0);
+    mWindLabel->setBrush(QBrush(Qt::red));
+    mWindLabel->setColor(Qt::white);
+    mWindLabel->setText(tr("Results are adjusted for wind"));
+    mWindLabel->setFont(QFont(font().family(), font().pointSize(), QFont::Black));
+    mWindLabel->setPadding(QMargins(2, 2, 2, 2));
+    mWindLabel->setVisible(false);
+
+    // Cursor items, shown as needed by updateCursor()
+    mSelectionRect = new QCPItemRect(this);
+    mSelectionRect->setLayer("overlay");
+    mSelectionRect->setPen(Qt::NoPen);
+    mSelectionRect->setBrush(QColor(181, 217, 42, 64));
+    mSelectionRect->topLeft->setType(QCPItemPosition::ptPlotCoords);
+    mSelectionRect->bottomRight->setType(QCPItemPosition::ptPlotCoords);
+    mSelectionRect->setVisible(false);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        mCursorLines[i] = new QCPItemLine(this);
+        mCursorLines[i]->setLayer("overlay");
+        mCursorLines[i]->setPen(QPen(Qt::black));
+        mCursorLines[i]->setVisible(false);
+    }
 }
 
 void DataPlot::readSettings()
@@ -252,6 +286,14 @@ void DataPlot::leaveEvent(
     update();
 }
 
+void DataPlot::resizeEvent(
+        QResizeEvent *event)
+{
+    // Sample density follows the plot width
+    updateSeries();
+    QCustomPlot::resizeEvent(event);
+}
+
 void DataPlot::setMark(
         double start,
         double end)
@@ -261,6 +303,9 @@ void DataPlot::setMark(
 
     if (mMainWindow->dataSize() == 0) return;
 
+    // Wait for series to be rebuilt after the data changes
+    if (!mSeries.isEmpty() && mSeries.first().pyramid.size() != mMainWindow->dataSize()) return;
+
     QString status;
     if (dpStart.dateTime.date() == dpEnd.dateTime.date())
     {
@@ -319,70 +364,62 @@ void DataPlot::setMark(
     DataPoint dpLow = interpolateDataX(low);
     DataPoint dpHigh = interpolateDataX(high);
 
+    const double tLow = m_xValues[Time]->value(dpLow, mMainWindow->units());
+    const double tHigh = m_xValues[Time]->value(dpHigh, mMainWindow->units());
+
+    // Samples strictly inside the measured range
     const int jMin = findIndexAboveX(low);
     const int jMax = findIndexBelowX(high);
 
-    const DataPoint &dpMin = mMainWindow->dataPoint(jMin);
-    const DataPoint &dpMax = mMainWindow->dataPoint(jMax);
-
-    for (int i = 0; i < yaLast; ++i)
+    for (int i = 0; i < mSeries.size(); ++i)
     {
-        if (yValue(i)->visible())
-        {
-            double dx = m_xValues[Time]->value(dpMin, mMainWindow->units())
-                    - m_xValues[Time]->value(dpLow, mMainWindow->units());
-            double avg = (yValue(i)->value(dpMin, mMainWindow->units())
-                    + yValue(i)->value(dpLow, mMainWindow->units())) / 2;
-
-            double sum = avg * fabs(dx);
-            double dxSum = fabs(dx);
+        const Series &series = mSeries[i];
+        PlotValue *value = series.value;
 
-            double min = yValue(i)->value(dpLow, mMainWindow->units());
-            double max = min;
+        const double yLow = value->value(dpLow, mMainWindow->units());
+        const double yHigh = value->value(dpHigh, mMainWindow->units());
 
-            for (int j = jMin ; j < jMax ; ++ j)
-            {
-                const DataPoint &dp1 = mMainWindow->dataPoint(j);
-                const DataPoint &dp2 = mMainWindow->dataPoint(j + 1);
-
-                dx = m_xValues[Time]->value(dp2, mMainWindow->units())
-                        - m_xValues[Time]->value(dp1, mMainWindow->units());
-                avg = (yValue(i)->value(dp2, mMainWindow->units())
-                        + yValue(i)->value(dp1, mMainWindow->units())) / 2;
+        double min = qMin(yLow, yHigh);
+        double max = qMax(yLow, yHigh);
 
-                sum += avg * fabs(dx) ;
-                dxSum += fabs(dx);
-
-                min = qMin(min, yValue(i)->value(dp1, mMainWindow->units()));
-                max = qMax(max, yValue(i)->value(dp1, mMainWindow->units()));
-            }
+        const double dxSum = tHigh - tLow;
+        double sum;
 
-            min = qMin(min, yValue(i)->value(dpMax, mMainWindow->units()));
-            max = qMax(max, yValue(i)->value(dpMax, mMainWindow->units()));
+        if (jMin <= jMax)
+        {
+            const DataPoint &dpMin = mMainWindow->dataPoint(jMin);
+            const DataPoint &dpMax = mMainWindow->dataPoint(jMax);
 
-            dx = m_xValues[Time]->value(dpHigh, mMainWindow->units())
-                    - m_xValues[Time]->value(dpMax, mMainWindow->units());
-            avg = (yValue(i)->value(dpHigh, mMainWindow->units())
-                    + yValue(i)->value(dpMax, mMainWindow->units())) / 2;
+            const double yMin = value->value(dpMin, mMainWindow->units());
+            const double yMax = value->value(dpMax, mMainWindow->units());
 
-            sum += avg * fabs(dx) ;
-            dxSum += fabs(dx);
+            // Partial intervals at either end plus the whole ones between
+            sum = (yLow + yMin) / 2 * (m_xValues[Time]->value(dpMin, mMainWindow->units()) - tLow)
+                    + series.integral.integral(jMin, jMax)
+                    + (yMax + yHigh) / 2 * (tHigh - m_xValues[Time]->value(dpMax, mMainWindow->units()));
 
-            min = qMin(min, yValue(i)->value(dpHigh, mMainWindow->units()));
-            max = qMax(max, yValue(i)->value(dpHigh, mMainWindow->units()));
+            double minInside, maxInside;
+            series.pyramid.sampleExtrema(jMin, jMax, minInside, maxInside);
 
-            change = yValue(i)->value(dpEnd, mMainWindow->units())
-                    - yValue(i)->value(dpStart, mMainWindow->units());
-            status += QString("<tr style='color:%5;'><td>%1</td><td>%2</td><td>(%3%4)</td><td>[%6/%7/%8]</td></tr>")
-                    .arg(yValue(i)->title(mMainWindow->units()))
-                    .arg(yValue(i)->value(dpEnd, mMainWindow->units()))
-                    .arg(change < 0 ? "" : "+")
-                    .arg(change)
-                    .arg(yValue(i)->color().name())
-                    .arg(min)
-                    .arg(sum / dxSum)
-                    .arg(max);
+            min = qMin(min, minInside);
+            max = qMax(max, maxInside);
+        }
+        else
+        {
+            sum = (yLow + yHigh) / 2 * dxSum;
         }
+
+        change = value->value(dpEnd, mMainWindow->units())
+                - value->value(dpStart, mMainWindow->units());
+        status += QString("<tr style='color:%5;'><td>%1</td><td>%2</td><td>(%3%4)</td><td>[%6/%7/%8]</td></tr>")
+                .arg(value->title(mMainWindow->units()))
+                .arg(value->value(dpEnd, mMainWindow->units()))
+                .arg(change < 0 ? "" : "+")
+                .arg(change)
+                .arg(value->color().name())
+                .arg(min)
+                .arg(sum / dxSum)
+                .arg(max);
     }
 
     status += QString("</table>");
@@ -449,6 +486,10 @@ void DataPlot::setRange(
     DataPoint dpLower = interpolateDataX(range.lower);
     DataPoint dpUpper = interpolateDataX(range.upper);
 
+    // Views are refreshed later, but mouse handling needs the new range now
+    xAxis->setRange(QCPRange(xValue()->value(dpLower, mMainWindow->units()),
+                             xValue()->value(dpUpper, mMainWindow->units())));
+
     mMainWindow->setRange(dpLower.t, dpUpper.t);
 }
 
@@ -456,154 +497,253 @@ void DataPlot::updateYRanges()
 {
     const QCPRange &range = xAxis->range();
 
-    int k = 0;
-    for (int j = 0; j < yaLast; ++j)
+    for (int i = 0; i < mSeries.size(); ++i)
     {
-        if (!yValue(j)->visible()) continue;
+        const Series &series = mSeries[i];
 
         double yMin, yMax;
-        bool first = true;
+        bool found = series.pyramid.extrema(range.lower, range.upper, yMin, yMax);
 
-        for (int i = 0; i < mMainWindow->dataSize(); ++i)
+        double yMinOptimal, yMaxOptimal;
+        if (series.optimal.extrema(range.lower, range.upper, yMinOptimal, yMaxOptimal))
         {
-            const DataPoint &dp = mMainWindow->dataPoint(i);
-
-            if (range.contains(xValue()->value(dp, mMainWindow->units())))
-            {
-                double y = yValue(j)->value(dp, mMainWindow->units());
-
-                if (first)
-                {
-                    yMin = yMax = y;
-                    first = false;
-                }
-                else
-                {
-                    if (y < yMin) yMin = y;
-                    if (y > yMax) yMax = y;
-                }
-            }
+            yMin = found ? qMin(yMin, yMinOptimal) : yMinOptimal;
+            yMax = found ? qMax(yMax, yMaxOptimal) : yMaxOptimal;
+            found = true;
         }
 
-        if (yValue(j)->hasOptimal())
+        if (found)
         {
-            for (int i = 0; i < mMainWindow->optimalSize(); ++i)
-            {
-                const DataPoint &dp = mMainWindow->optimalPoint(i);
-
-                if (range.contains(xValue()->value(dp, mMainWindow->units())))
-                {
-                    double y = yValue(j)->value(dp, mMainWindow->units());
-
-                    if (first)
-                    {
-                        yMin = yMax = y;
-                        first = false;
-                    }
-                    else
-                    {
-                        if (y < yMin) yMin = y;
-                        if (y > yMax) yMax = y;
-                    }
-                }
-            }
+            PlotValue *value = series.value;
+            const double factor = value->factor(mMainWindow->units());
+            value->axis()->setRange(
+                        value->useMinimum() ? value->minimum() * factor : yMin,
+                        value->useMaximum() ? value->maximum() * factor : yMax);
         }
+    }
+}
 
-        if (!first)
-        {
-            const double factor = yValue(j)->factor(mMainWindow->units());
-            axisRect()->axis(QCPAxis::atLeft, k++)->setRange(
-                        yValue(j)->useMinimum() ? yValue(j)->minimum() * factor : yMin,
-                        yValue(j)->useMaximum() ? yValue(j)->maximum() * factor : yMax);
-        }
+void DataPlot::updateSeries()
+{
+    const QCPRange &range = xAxis->range();
+
+    QVector< double > x, y;
+    for (int i = 0; i < mSeries.size(); ++i)
+    {
+        mSeries[i].pyramid.sample(range.lower, range.upper, width(), x, y);
+        mSeries[i].graph->setData(x, y, true);
     }
 }
 
-void DataPlot::updatePlot()
+QVector< double > DataPlot::column(
+        const PlotValue *value)
 {
-    clearPlottables();
-    clearItems();
+    QHash< const PlotValue*, QVector< double > >::const_iterator it = mColumns.constFind(value);
+    if (it != mColumns.constEnd()) return it.value();
 
-    xAxis->setLabel(xValue()->title(mMainWindow->units()));
+    const QVector< double > result = value->values(mMainWindow->data(), mMainWindow->units());
+    mColumns.insert(value, result);
+    return result;
+}
 
-    // Remove all axes
-    while (axisRect()->axisCount(QCPAxis::atLeft) > 0)
+void DataPlot::clearColumns()
+{
+    mColumns.clear();
+}
+
+void DataPlot::hideCursor()
+{
+    for (int i = 0; i < mSeries.size(); ++i)
     {
-        axisRect()->removeAxis(axisRect()->axis(QCPAxis::atLeft, 0));
+        mSeries[i].markGraph->setVisible(false);
     }
 
-    // Add axes for visible plots
-    for (int j = 0; j < yaLast; ++j)
+    mSelectionRect->setVisible(false);
+    mCursorLines[0]->setVisible(false);
+    mCursorLines[1]->setVisible(false);
+}
+
+void DataPlot::showCursorLine(
+        QCPItemLine *line,
+        double x1,
+        double y1,
+        double x2,
+        double y2)
+{
+    line->start->setAxes(xAxis, yAxis);
+    line->start->setCoords(x1, y1);
+    line->end->setAxes(xAxis, yAxis);
+    line->end->setCoords(x2, y2);
+    line->setVisible(true);
+}
+
+void DataPlot::beginAnnotations()
+{
+    mAnnotationGraphsUsed = 0;
+    mAnnotationRectsUsed = 0;
+}
+
+QCPGraph *DataPlot::annotationGraph(
+        QCPAxis *keyAxis,
+        QCPAxis *valueAxis)
+{
+    if (mAnnotationGraphsUsed == mAnnotationGraphs.size())
     {
-        if (!yValue(j)->visible()) continue;
-        yValue(j)->addAxis(this, mMainWindow->units());
+        QCPGraph *graph = addGraph(keyAxis, valueAxis);
+        graph->setLayer("background");
+        mAnnotationGraphs.append(graph);
     }
 
-    // Return now if plot empty
-    if (mMainWindow->dataSize() == 0) return;
+    QCPGraph *graph = mAnnotationGraphs[mAnnotationGraphsUsed++];
+    graph->setKeyAxis(keyAxis);
+    graph->setValueAxis(valueAxis);
+    graph->setVisible(true);
+    return graph;
+}
 
-    // Get plot range
-    DataPoint dpLower = mMainWindow->interpolateDataT(mMainWindow->rangeLower());
-    DataPoint dpUpper = mMainWindow->interpolateDataT(mMainWindow->rangeUpper());
+QCPItemRect *DataPlot::annotationRect()
+{
+    if (mAnnotationRectsUsed == mAnnotationRects.size())
+    {
+        QCPItemRect *rect = new QCPItemRect(this);
+        rect->setLayer("background");
+        mAnnotationRects.append(rect);
+    }
 
-    QVector< double > x;
-    for (int i = 0; i < mMainWindow->dataSize(); ++i)
+    QCPItemRect *rect = mAnnotationRects[mAnnotationRectsUsed++];
+    rect->setVisible(true);
+    return rect;
+}
+
+void DataPlot::endAnnotations()
+{
+    for (int i = mAnnotationGraphsUsed; i < mAnnotationGraphs.size(); ++i)
     {
-        const DataPoint &dp = mMainWindow->dataPoint(i);
-        x.append(xValue()->value(dp, mMainWindow->units()));
+        mAnnotationGraphs[i]->setVisible(false);
     }
 
-    // Draw plots
-    for (int j = 0; j < yaLast; ++j)
+    for (int i = mAnnotationRectsUsed; i < mAnnotationRects.size(); ++i)
     {
-        if (!yValue(j)->visible()) continue;
+        mAnnotationRects[i]->setVisible(false);
+    }
+}
+
+int DataPlot::findSeries(
+        int type) const
+{
+    for (int i = 0; i < mSeries.size(); ++i)
+    {
+        if (mSeries[i].type == type) return i;
+    }
+    return -1;
+}
 
-        QVector< double > y;
-        for (int i = 0; i < mMainWindow->dataSize(); ++i)
+void DataPlot::addSeries(
+        int type)
+{
+    PlotValue *value = yValue(type);
+    QCPAxis *axis = value->addAxis(this, mMainWindow->units());
+
+    Series series;
+    series.type = type;
+    series.value = value;
+    series.graph = addGraph(xAxis, axis);
+    series.optimalGraph = value->hasOptimal() ? addGraph(xAxis, axis) : 0;
+
+    series.markGraph = addGraph(xAxis, axis);
+    series.markGraph->setLayer("overlay");
+    series.markGraph->setLineStyle(QCPGraph::lsNone);
+    series.markGraph->setScatterStyle(QCPScatterStyle::ssDisc);
+    series.markGraph->setVisible(false);
+
+    mSeries.append(series);
+}
+
+void DataPlot::removeSeries(
+        int i)
+{
+    const Series &series = mSeries[i];
+
+    removeGraph(series.graph);
+    if (series.optimalGraph) removeGraph(series.optimalGraph);
+    removeGraph(series.markGraph);
+    axisRect()->removeAxis(series.value->axis());
+
+    mSeries.remove(i);
+}
+
+void DataPlot::updatePlot()
+{
+    ProfileScope scope("DataPlot::updatePlot");
+
+    xAxis->setLabel(xValue()->title(mMainWindow->units()));
+
+    // Axes are stacked in series order, so new series also replace any
+    // which come after them
+    int firstAdded = yaLast;
+    for (int j = 0; j < yaLast; ++j)
+    {
+        if (yValue(j)->visible() && findSeries(j) < 0)
         {
-            const DataPoint &dp = mMainWindow->dataPoint(i);
-            y.append(yValue(j)->value(dp, mMainWindow->units()));
+            firstAdded = j;
+            break;
         }
+    }
 
-        QCPAxis *axis = yValue(j)->axis();
-        QCPGraph *graph = addGraph(
-                    axisRect()->axis(QCPAxis::atBottom),
-                    axis);
-        graph->setData(x, y);
-        graph->setPen(QPen(yValue(j)->color(), mMainWindow->lineThickness()));
+    for (int i = mSeries.size() - 1; i >= 0; --i)
+    {
+        const int j = mSeries[i].type;
+        if (!yValue(j)->visible() || j > firstAdded) removeSeries(i);
+    }
+
+    for (int j = firstAdded; j < yaLast; ++j)
+    {
+        if (yValue(j)->visible() && findSeries(j) < 0) addSeries(j);
+    }
+
+    const QVector< double > x = column(xValue());
+    const QVector< double > t = column(m_xValues[Time]);
+
+    const QVector< double > xOptimal = xValue()->values(mMainWindow->optimal(), mMainWindow->units());
+
+    // Refresh the data and appearance of each series
+    for (int i = 0; i < mSeries.size(); ++i)
+    {
+        Series &series = mSeries[i];
+        PlotValue *value = series.value;
+
+        const QVector< double > y = column(value);
+
+        value->updateAxis(mMainWindow->units());
+        series.graph->setPen(QPen(value->color(), mMainWindow->lineThickness()));
+
+        // Data is filled in for the visible range by updateSeries()
+        series.pyramid = MinMaxPyramid(x, y);
+        series.integral = PrefixIntegral(t, y);
 
-        if (yValue(j)->hasOptimal())
+        if (series.optimalGraph)
         {
-            QVector< double > xOptimal, yOptimal;
-            for (int i = 0; i < mMainWindow->optimalSize(); ++i)
-            {
-                const DataPoint &dp = mMainWindow->optimalPoint(i);
-                xOptimal.append(xValue()->value(dp, mMainWindow->units()));
-                yOptimal.append(yValue(j)->value(dp, mMainWindow->units()));
-            }
+            const QVector< double > yOptimal = value->values(mMainWindow->optimal(), mMainWindow->units());
 
-            QCPGraph *graph = addGraph(
-                        axisRect()->axis(QCPAxis::atBottom),
-                        axis);
-            graph->setData(xOptimal, yOptimal);
-            graph->setPen(QPen(QBrush(yValue(j)->color()), mMainWindow->lineThickness(), Qt::DotLine));
+            series.optimalGraph->setData(xOptimal, yOptimal);
+            series.optimalGraph->setPen(QPen(QBrush(value->color()), mMainWindow->lineThickness(), Qt::DotLine));
+
+            series.optimal = MinMaxPyramid(xOptimal, yOptimal);
         }
     }
 
-    if (mMainWindow->windAdjustment())
+    mWindLabel->setVisible(mMainWindow->windAdjustment() && mMainWindow->dataSize() > 0);
+
+    // Clear what is left of the previous track if plot empty
+    if (mMainWindow->dataSize() == 0)
     {
-        // Add label to indicate wind correction
-        QCPItemText *textLabel = new QCPItemText(this);
+        updateSeries();
 
-        textLabel->setPositionAlignment(Qt::AlignTop|Qt::AlignRight);
-        textLabel->setTextAlignment(Qt::AlignRight);
-        textLabel->position->setType(QCPItemPosition::ptAxisRectRatio);
-        textLabel->position->setCoords(1, 0);
-        textLabel->setBrush(QBrush(Qt::red));
-        textLabel->setColor(Qt::white);
-        textLabel->setText(tr("Results are adjusted for wind"));
-        textLabel->setFont(QFont(font().family(), font().pointSize(), QFont::Black));
-        textLabel->setPadding(QMargins(2, 2, 2, 2));
+        beginAnnotations();
+        endAnnotations();
+
+        hideCursor();
+        return;
     }
 
     updateRange();
@@ -611,6 +751,8 @@ void DataPlot::updatePlot()
 
 void DataPlot::updateRange()
 {
+    ProfileScope scope("DataPlot::updateRange");
+
     if (mMainWindow->dataSize() == 0) return;
 
     // Get plot range
@@ -626,6 +768,9 @@ void DataPlot::updateRange()
     // Set y-axis ranges
     updateYRanges();
 
+    // Resample series for the new range
+    updateSeries();
+
     // Draw annotations on plot background
     mMainWindow->prepareDataPlot(this);
 
@@ -635,19 +780,9 @@ void DataPlot::updateRange()
 
 void DataPlot::updateCursor()
 {
-    setCurrentLayer("overlay");
+    ProfileScope scope("DataPlot::updateCursor");
 
-    foreach (QCPLayerable *l, currentLayer()->children())
-    {
-        if (qobject_cast<QCPAbstractPlottable*>(l))
-        {
-            removePlottable((QCPAbstractPlottable*) l);
-        }
-        else if (qobject_cast<QCPAbstractItem*>(l))
-        {
-            removeItem((QCPAbstractItem*) l);
-        }
-    }
+    hideCursor();
 
     if (mMainWindow->markActive())
     {
@@ -657,20 +792,16 @@ void DataPlot::updateCursor()
         QVector< double > xMark, yMark;
         xMark.append(xValue()->value(dpEnd, mMainWindow->units()));
 
-        for (int j = 0; j < yaLast; ++j)
+        for (int i = 0; i < mSeries.size(); ++i)
         {
-            if (!yValue(j)->visible()) continue;
+            const Series &series = mSeries[i];
 
             yMark.clear();
-            yMark.append(yValue(j)->value(dpEnd, mMainWindow->units()));
-
-            QCPAxis *axis = yValue(j)->axis();
-            QCPGraph *graph = addGraph(xAxis, axis);
+            yMark.append(series.value->value(dpEnd, mMainWindow->units()));
 
-            graph->setData(xMark, yMark);
-            graph->setPen(QPen(Qt::black, mMainWindow->lineThickness()));
-            graph->setLineStyle(QCPGraph::lsNone);
-            graph->setScatterStyle(QCPScatterStyle::ssDisc);
+            series.markGraph->setData(xMark, yMark);
+            series.markGraph->setPen(QPen(Qt::black, mMainWindow->lineThickness()));
+            series.markGraph->setVisible(true);
         }
 
         // Update hover text
@@ -701,45 +832,32 @@ void DataPlot::updateCursor()
     else if (m_dragging && (tool == MainWindow::Zoom || tool == MainWindow::Measure))
     {
         // Draw shading
-        QCPItemRect *rect = new QCPItemRect(this);
-
-        rect->setPen(Qt::NoPen);
-        rect->setBrush(QColor(181, 217, 42, 64));
+        mSelectionRect->topLeft->setAxes(xAxis, yAxis);
+        mSelectionRect->topLeft->setCoords(m_tBegin, yAxis->range().upper);
 
-        rect->topLeft->setType(QCPItemPosition::ptPlotCoords);
-        rect->topLeft->setAxes(xAxis, yAxis);
-        rect->topLeft->setCoords(m_tBegin, yAxis->range().upper);
+        mSelectionRect->bottomRight->setAxes(xAxis, yAxis);
+        mSelectionRect->bottomRight->setCoords(m_tCursor, yAxis->range().lower);
 
-        rect->bottomRight->setType(QCPItemPosition::ptPlotCoords);
-        rect->bottomRight->setAxes(xAxis, yAxis);
-        rect->bottomRight->setCoords(m_tCursor, yAxis->range().lower);
+        mSelectionRect->setVisible(true);
 
-        QCPItemLine *line = new QCPItemLine(this);
-        line->setPen(QPen(Qt::black));
-        line->start->setCoords(m_tBegin, yAxis->range().lower);
-        line->end->setCoords(m_tBegin, yAxis->range().upper);
-
-        line = new QCPItemLine(this);
-        line->setPen(QPen(Qt::black));
-        line->start->setCoords(m_tCursor, yAxis->range().lower);
-        line->end->setCoords(m_tCursor, yAxis->range().upper);
+        showCursorLine(mCursorLines[0],
+                       m_tBegin, yAxis->range().lower,
+                       m_tBegin, yAxis->range().upper);
+        showCursorLine(mCursorLines[1],
+                       m_tCursor, yAxis->range().lower,
+                       m_tCursor, yAxis->range().upper);
     }
     else
     {
         // Draw crosshairs
-        QCPItemLine *line = new QCPItemLine(this);
-        line->setPen(QPen(Qt::black));
-        line->start->setCoords(xAxis->range().lower, yAxis->pixelToCoord(m_yCursor));
-        line->end->setCoords(xAxis->range().upper, yAxis->pixelToCoord(m_yCursor));
-
-        line = new QCPItemLine(this);
-        line->setPen(QPen(Qt::black));
-        line->start->setCoords(m_tCursor, yAxis->range().lower);
-        line->end->setCoords(m_tCursor, yAxis->range().upper);
+        showCursorLine(mCursorLines[0],
+                       xAxis->range().lower, yAxis->pixelToCoord(m_yCursor),
+                       xAxis->range().upper, yAxis->pixelToCoord(m_yCursor));
+        showCursorLine(mCursorLines[1],
+                       m_tCursor, yAxis->range().lower,
+                       m_tCursor, yAxis->range().upper);
     }
 
-    setCurrentLayer("main");
-
     replot();
 }
 
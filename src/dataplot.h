@@ -24,10 +24,14 @@
 #ifndef DATAPLOT_H
 #define DATAPLOT_H
 
+#include <QHash>
+
 #include "QCustomPlot/qcustomplot.h"
 
 #include "datapoint.h"
+#include "minmaxpyramid.h"
 #include "plotvalue.h"
+#include "prefixintegral.h"
 
 class MainWindow;
 
@@ -79,6 +83,14 @@ public:
     void setXAxisType(XAxisType xAxisType);
     XAxisType xAxisType() const { return m_xAxisType ; }
 
+    // Annotations on the plot background, kept from one range change to
+    // the next. Anything not requested again between begin and end is
+    // hidden rather than deleted.
+    void beginAnnotations();
+    QCPGraph *annotationGraph(QCPAxis *keyAxis, QCPAxis *valueAxis);
+    QCPItemRect *annotationRect();
+    void endAnnotations();
+
 protected:
     void mousePressEvent(QMouseEvent *event);
     void mouseReleaseEvent(QMouseEvent *event);
@@ -88,7 +100,20 @@ protected:
 
     void leaveEvent(QEvent *);
 
+    void resizeEvent(QResizeEvent *event);
+
 private:
+    typedef struct {
+        int            type;
+        PlotValue     *value;
+        QCPGraph      *graph;
+        QCPGraph      *optimalGraph;
+        QCPGraph      *markGraph;
+        MinMaxPyramid  pyramid;
+        MinMaxPyramid  optimal;
+        PrefixIntegral integral;
+    } Series;
+
     double m_tCursor, m_tBegin;
     int m_yCursor, m_yBegin;
     bool m_cursorValid;
@@ -102,7 +127,31 @@ private:
 
     QVector< PlotValue* > m_yValues;
 
+    QVector< Series >     mSeries;
+    QCPItemText          *mWindLabel;
+    QCPItemRect          *mSelectionRect;
+    QCPItemLine          *mCursorLines[2];
+
+    QList< QCPGraph* >    mAnnotationGraphs;
+    QList< QCPItemRect* > mAnnotationRects;
+    int                   mAnnotationGraphsUsed;
+    int                   mAnnotationRectsUsed;
+
+    // Values of each series over the whole track, kept until the data changes
+    QHash< const PlotValue*, QVector< double > > mColumns;
+
     void updateYRanges();
+    void updateSeries();
+
+    int findSeries(int type) const;
+    void addSeries(int type);
+    void removeSeries(int i);
+
+    void hideCursor();
+    void showCursorLine(QCPItemLine *line,
+                        double x1, double y1, double x2, double y2);
+
+    QVector< double > column(const PlotValue *value);
     void setRange(const QCPRange &range);
 
     void setMark(double start, double end);
@@ -119,6 +168,8 @@ private:
     void writeSettings();
 
 public slots:
+    void clearColumns();
+
     void updatePlot();
     void updateRange();
     void updateCursor();
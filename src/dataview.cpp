@@ -25,6 +25,7 @@
 
 #include "common.h"
 #include "mainwindow.h"
+#include "profiler.h"
 
 #define WINDOW_MARGIN 1.2
 
@@ -125,6 +126,8 @@ void DataView::mouseMoveEvent(
 
 void DataView::updateView()
 {
+    ProfileScope scope("DataView::updateView");
+
     clearPlottables();
 
     m_cursors.clear();
@@ -331,6 +334,8 @@ void DataView::updateView()
 
 void DataView::updateCursor()
 {
+    ProfileScope scope("DataView::updateCursor");
+
     for (int i = 0; i < m_cursors.size(); ++i)
     {
         removeGraph(m_cursors[i]);
@@ -0,0 +1,134 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "fitnesscache.h"
+
+#include <string.h>
+
+#include "genome.h"
+#include "randomstream.h"
+
+FitnessCache::Hasher::Hasher():
+    mH1(Q_UINT64_C(0x243F6A8885A308D3)),
+    mH2(Q_UINT64_C(0x13198A2E03707344))
+{
+
+}
+
+void FitnessCache::Hasher::add(
+        quint64 value)
+{
+    mH1 = RandomStream::mix(mH1 ^ value);
+    mH2 = RandomStream::mix(mH2 + value) ^ mH1;
+}
+
+void FitnessCache::Hasher::add(
+        double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    add(bits);
+}
+
+FitnessCache::Key FitnessCache::Hasher::result() const
+{
+    Key key;
+    key.h1 = mH1;
+    key.h2 = mH2;
+    return key;
+}
+
+FitnessCache::FitnessCache():
+    mHasContext(false)
+{
+
+}
+
+FitnessCache::Key FitnessCache::key(
+        const Genome &genome)
+{
+    Hasher hasher;
+
+    hasher.add((quint64) genome.size());
+    for (int i = 0; i < genome.size(); ++i)
+    {
+        hasher.add((quint64) qRound64(genome[i] * 1e9));
+    }
+
+    return hasher.result();
+}
+
+void FitnessCache::setContext(
+        const Key &context)
+{
+    QWriteLocker locker(&mLock);
+
+    if (!mHasContext || !(mContext == context))
+    {
+        mScores.clear();
+        mContext = context;
+        mHasContext = true;
+    }
+}
+
+void FitnessCache::clear()
+{
+    QWriteLocker locker(&mLock);
+
+    mScores.clear();
+    mHasContext = false;
+}
+
+bool FitnessCache::find(
+        const Key &key,
+        double &score) const
+{
+    QReadLocker locker(&mLock);
+
+    QHash< Key, double >::const_iterator it = mScores.constFind(key);
+    if (it == mScores.constEnd()) return false;
+
+    score = it.value();
+    return true;
+}
+
+void FitnessCache::insert(
+        const Key &key,
+        double score)
+{
+    QWriteLocker locker(&mLock);
+
+    // Start over rather than growing without bound
+    if (mScores.size() >= maxSize)
+    {
+        mScores.clear();
+    }
+
+    mScores.insert(key, score);
+}
+
+int FitnessCache::size() const
+{
+    QReadLocker locker(&mLock);
+    return mScores.size();
+}
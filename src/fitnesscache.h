@@ -0,0 +1,92 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef FITNESSCACHE_H
+#define FITNESSCACHE_H
+
+#include <QHash>
+#include <QReadWriteLock>
+
+class Genome;
+
+// Scores of genomes which have already been simulated. Genomes are
+// identified by a 128-bit hash of their lift coefficients, rounded to
+// 1e-9, and entries are valid for a single context (the simulation
+// parameters). Safe to use from several threads.
+
+class FitnessCache
+{
+public:
+    typedef struct {
+        quint64 h1;
+        quint64 h2;
+    } Key;
+
+    // Builds a key from a sequence of values
+    class Hasher
+    {
+    public:
+        Hasher();
+
+        void add(quint64 value);
+        void add(double value);
+
+        Key result() const;
+
+    private:
+        quint64 mH1, mH2;
+    };
+
+    FitnessCache();
+
+    static Key key(const Genome &genome);
+
+    // Clears the cache if the context has changed
+    void setContext(const Key &context);
+    void clear();
+
+    bool find(const Key &key, double &score) const;
+    void insert(const Key &key, double score);
+
+    int size() const;
+
+private:
+    static const int maxSize = 1 << 20;
+
+    mutable QReadWriteLock  mLock;
+    QHash< Key, double >    mScores;
+    Key                     mContext;
+    bool                    mHasContext;
+};
+
+inline bool operator==(const FitnessCache::Key &k1, const FitnessCache::Key &k2)
+{
+    return k1.h1 == k2.h1 && k1.h2 == k2.h2;
+}
+
+inline uint qHash(const FitnessCache::Key &key, uint seed = 0)
+{
+    return (uint) (key.h1 ^ seed);
+}
+
+#endif // FITNESSCACHE_H
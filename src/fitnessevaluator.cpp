@@ -0,0 +1,106 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "fitnessevaluator.h"
+
+#include <QtNumeric>
+
+#include "trajectory.h"
+
+WindowEvaluator::WindowEvaluator(
+        double windowTop,
+        double windowBottom):
+    mWindowTop(windowTop),
+    mWindowBottom(windowBottom)
+{
+
+}
+
+void WindowEvaluator::start(
+        const Trajectory &trajectory)
+{
+    mAbove = (trajectory.z(0) > mWindowTop);
+    mFoundTop = false;
+    mValidTop = false;
+    mFoundBottom = false;
+}
+
+bool WindowEvaluator::add(
+        const Trajectory &trajectory)
+{
+    const int i = trajectory.size() - 1;
+    const double z = trajectory.z(i);
+
+    // Simulation has diverged
+    if (qIsNaN(z)) return false;
+
+    if (!mFoundTop && z < mWindowTop)
+    {
+        // Only valid if we started above the window
+        mTop = crossing(trajectory, i, mWindowTop);
+        mFoundTop = true;
+        mValidTop = mAbove;
+    }
+
+    if (z > mWindowTop)
+    {
+        mAbove = true;
+    }
+
+    if (z < mWindowBottom)
+    {
+        mBottom = crossing(trajectory, i, mWindowBottom);
+        mFoundBottom = true;
+        return false;
+    }
+
+    return true;
+}
+
+double WindowEvaluator::score() const
+{
+    if (mValidTop && mFoundBottom)
+    {
+        return score(mTop, mBottom);
+    }
+
+    return 0;
+}
+
+WindowEvaluator::Crossing WindowEvaluator::crossing(
+        const Trajectory &trajectory,
+        int i,
+        double z)
+{
+    const double z1 = trajectory.z(i - 1);
+    const double z2 = trajectory.z(i);
+    const double a = (z - z1) / (z2 - z1);
+
+    Crossing ret;
+
+    ret.t = trajectory.t(i - 1) + a * (trajectory.t(i) - trajectory.t(i - 1));
+    ret.x = trajectory.x(i - 1) + a * (trajectory.x(i) - trajectory.x(i - 1));
+    ret.y = trajectory.y(i - 1) + a * (trajectory.y(i) - trajectory.y(i - 1));
+
+    return ret;
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef FITNESSEVALUATOR_H
+#define FITNESSEVALUATOR_H
+
+class Trajectory;
+
+// Scores a simulated trajectory while it is being generated. The simulator
+// calls start() with the initial point and add() after every step, and
+// stops as soon as add() returns false.
+
+class FitnessEvaluator
+{
+public:
+    virtual ~FitnessEvaluator() {}
+
+    virtual void start(const Trajectory &trajectory) = 0;
+    virtual bool add(const Trajectory &trajectory) = 0;
+    virtual double score() const = 0;
+};
+
+// Finds where a simulated trajectory enters and leaves a performance
+// window, matching getWindowBounds() in the scoring methods
+
+class WindowEvaluator : public FitnessEvaluator
+{
+public:
+    typedef struct {
+        double t;
+        double x;
+        double y;
+    } Crossing;
+
+    WindowEvaluator(double windowTop, double windowBottom);
+
+    void start(const Trajectory &trajectory);
+    bool add(const Trajectory &trajectory);
+    double score() const;
+
+protected:
+    virtual double score(const Crossing &top, const Crossing &bottom) const = 0;
+
+    double windowTop() const { return mWindowTop; }
+    double windowBottom() const { return mWindowBottom; }
+
+private:
+    double      mWindowTop;
+    double      mWindowBottom;
+
+    bool        mAbove;
+    bool        mFoundTop;
+    bool        mValidTop;
+    bool        mFoundBottom;
+
+    Crossing    mTop;
+    Crossing    mBottom;
+
+    static Crossing crossing(const Trajectory &trajectory, int i, double z);
+};
+
+#endif // FITNESSEVALUATOR_H
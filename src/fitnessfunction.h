@@ -0,0 +1,49 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef FITNESSFUNCTION_H
+#define FITNESSFUNCTION_H
+
+#include <QVector>
+
+#include "datapoint.h"
+
+class FitnessCache;
+class FitnessEvaluator;
+
+// What an optimizer maximizes. Evaluators score trajectories as they are
+// simulated; score() is the fallback when no evaluator is available.
+
+class FitnessFunction
+{
+public:
+    virtual ~FitnessFunction() {}
+
+    virtual double score(const QVector< DataPoint > &result) = 0;
+    virtual FitnessEvaluator *createEvaluator() const = 0;
+
+    // Scores from previous optimizations
+    virtual FitnessCache *fitnessCache() = 0;
+};
+
+#endif // FITNESSFUNCTION_H
@@ -23,7 +23,67 @@
 
 #include "flarescoring.h"
 
+#include <QtNumeric>
+
 #include "mainwindow.h"
+#include "trajectory.h"
+
+namespace
+{
+
+// Tracks the largest continuous climb, as getWindowBounds() does
+class FlareEvaluator : public FitnessEvaluator
+{
+public:
+    FlareEvaluator(double windowBottom):
+        mWindowBottom(windowBottom) {}
+
+    void start(const Trajectory &trajectory)
+    {
+        mStart = trajectory.hMSL(0);
+        mPrev = mStart;
+        mBest = 0;
+    }
+
+    bool add(const Trajectory &trajectory)
+    {
+        const int i = trajectory.size() - 1;
+        const double hMSL = trajectory.hMSL(i);
+
+        // Simulation has diverged
+        if (qIsNaN(hMSL))
+        {
+            mBest = 0;
+            return false;
+        }
+
+        if (hMSL > mPrev)
+        {
+            mBest = qMax(mBest, hMSL - mStart);
+        }
+        else
+        {
+            mStart = hMSL;
+        }
+
+        mPrev = hMSL;
+
+        return trajectory.z(i) >= mWindowBottom;
+    }
+
+    double score() const
+    {
+        return mBest;
+    }
+
+private:
+    double mWindowBottom;
+    double mStart;
+    double mPrev;
+    double mBest;
+};
+
+} // namespace
 
 FlareScoring::FlareScoring(
         MainWindow *mainWindow):
@@ -53,6 +113,11 @@ double FlareScoring::score(
     return 0;
 }
 
+FitnessEvaluator *FlareScoring::createEvaluator() const
+{
+    return new FlareEvaluator(mWindowBottom);
+}
+
 QString FlareScoring::scoreAsText(
         double score)
 {
@@ -93,7 +158,7 @@ void FlareScoring::prepareDataPlot(
         yElev << plot->yValue(DataPlot::Elevation)->value(dpBottom, mMainWindow->units())
               << plot->yValue(DataPlot::Elevation)->value(dpBottom, mMainWindow->units());
 
-        QCPGraph *graph = plot->addGraph(
+        QCPGraph *graph = plot->annotationGraph(
                     plot->axisRect()->axis(QCPAxis::atBottom),
                     plot->yValue(DataPlot::Elevation)->axis());
         graph->setData(xElev, yElev);
@@ -103,13 +168,13 @@ void FlareScoring::prepareDataPlot(
         yElev << plot->yValue(DataPlot::Elevation)->value(dpTop, mMainWindow->units())
               << plot->yValue(DataPlot::Elevation)->value(dpTop, mMainWindow->units());
 
-        graph = plot->addGraph(
+        graph = plot->annotationGraph(
                     plot->axisRect()->axis(QCPAxis::atBottom),
                     plot->yValue(DataPlot::Elevation)->axis());
         graph->setData(xElev, yElev);
         graph->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
 
-        QCPItemRect *rect = new QCPItemRect(plot);
+        QCPItemRect *rect = plot->annotationRect();
 
         rect->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
         rect->setBrush(QColor(0, 0, 0, 8));
@@ -124,7 +189,7 @@ void FlareScoring::prepareDataPlot(
                     (plot->xValue()->value(dpBottom, mMainWindow->units()) - xMin) / (xMax - xMin),
                     1.1);
 
-        rect = new QCPItemRect(plot);
+        rect = plot->annotationRect();
 
         rect->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
         rect->setBrush(QColor(0, 0, 0, 8));
@@ -0,0 +1,166 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "geneticoptimizer.h"
+
+namespace
+{
+
+const int workingSize    = 100;     // Working population
+const int keepSize       = 10;      // Number of elites to keep
+const int newSize        = 10;      // New genomes in first level
+const int numGenerations = 250;     // Generations per level of detail
+const int tournamentSize = 5;       // Number of individuals in a tournament
+const int mutationRate   = 100;     // Frequency of mutations
+const int truncationRate = 10;      // Frequency of truncations
+
+const Genome &selectGenome(
+        const GenePool &genePool,
+        RandomStream &random)
+{
+    int jMax;
+    double sMax;
+    bool first = true;
+
+    for (int i = 0; i < tournamentSize; ++i)
+    {
+        const int j = random.bounded(genePool.size());
+        if (first || genePool[j].first > sMax)
+        {
+            jMax = j;
+            sMax = genePool[j].first;
+            first = false;
+        }
+    }
+
+    return genePool[jMax].second;
+}
+
+} // namespace
+
+GeneticOptimizer::GeneticOptimizer(
+        FitnessFunction *function,
+        const Parameters &params,
+        QObject *parent):
+    Optimizer(function, params, parent)
+{
+
+}
+
+QVector< DataPoint > GeneticOptimizer::optimize()
+{
+    start();
+
+    int generation = 0;
+
+    // Add new individuals
+    GenePool genePool = breed(GenePool(), mKMin, generation++, workingSize, workingSize);
+    setBestScore(genePool);
+
+    addProgress(workingSize);
+
+    // Increasing levels of detail
+    for (int k = mKMin; k <= mKMax && !isCanceled(); ++k)
+    {
+        // Generations
+        for (int j = 0; j < numGenerations && !isCanceled(); ++j)
+        {
+            // Sort gene pool by score
+            qSort(genePool);
+
+            // Elitism
+            GenePool newGenePool = genePool.mid(0, keepSize);
+
+            // Add new individuals in first level, then offspring
+            const int numNew = (k == mKMin) ? newSize : 0;
+            newGenePool += breed(genePool, k, generation++, numNew,
+                                 workingSize - keepSize);
+
+            genePool = newGenePool;
+            setBestScore(genePool);
+
+            addProgress(workingSize);
+        }
+    }
+
+    // Sort gene pool by score
+    qSort(genePool);
+
+    // Keep most fit individual
+    return simulate(genePool[0].second);
+}
+
+int GeneticOptimizer::progressMaximum() const
+{
+    return (mKMax - mKMin + 1) * numGenerations * workingSize + workingSize;
+}
+
+GenePool GeneticOptimizer::breed(
+        const GenePool &genePool,
+        int k,
+        int generation,
+        int numNew,
+        int count)
+{
+    GenePool result;
+    for (int i = 0; i < count; ++i)
+    {
+        result.append(Score(0, create(genePool, k, generation, numNew, i)));
+    }
+
+    evaluate(result);
+    return result;
+}
+
+Genome GeneticOptimizer::create(
+        const GenePool &genePool,
+        int k,
+        int generation,
+        int numNew,
+        int i) const
+{
+    RandomStream random(mParams.seed, generation, i);
+
+    if (i < numNew)
+    {
+        // Add new individual
+        return Genome(mGenomeSize, mKMin, mParams.minLift, mParams.maxLift,
+                      random);
+    }
+
+    // Tournament selection
+    const Genome &p1 = selectGenome(genePool, random);
+    const Genome &p2 = selectGenome(genePool, random);
+    Genome g(p1, p2, k, random);
+
+    if (random.bounded(100) < truncationRate)
+    {
+        g.truncate(k);
+    }
+    if (random.bounded(100) < mutationRate)
+    {
+        g.mutate(k, mKMin, mParams.minLift, mParams.maxLift, random);
+    }
+
+    return g;
+}
@@ -0,0 +1,51 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef GENETICOPTIMIZER_H
+#define GENETICOPTIMIZER_H
+
+#include "optimizer.h"
+
+// Genetic optimizer for lift coefficient profiles, using tournament
+// selection and increasing levels of detail. Every new individual draws
+// from its own random stream, derived from the seed, generation and
+// position in the pool, so the result depends only on the seed and not on
+// thread scheduling.
+
+class GeneticOptimizer : public Optimizer
+{
+public:
+    GeneticOptimizer(FitnessFunction *function, const Parameters &params,
+                     QObject *parent = 0);
+
+    QVector< DataPoint > optimize();
+    int progressMaximum() const;
+
+private:
+    GenePool breed(const GenePool &genePool, int k, int generation,
+                   int numNew, int count);
+    Genome create(const GenePool &genePool, int k, int generation,
+                  int numNew, int i) const;
+};
+
+#endif // GENETICOPTIMIZER_H
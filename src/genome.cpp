@@ -37,12 +37,13 @@ Genome::Genome(
 Genome::Genome(
         const Genome &p1,
         const Genome &p2,
-        int k)
+        int k,
+        RandomStream &random)
 {
     const int parts = 1 << k;
     const int partSize = (p1.size() - 1) / parts;
 
-    const int pivot = qrand() % parts;
+    const int pivot = random.bounded(parts);
 
     const int j1 = pivot * partSize;
     const int j2 = (pivot + 1) * partSize;
@@ -62,15 +63,16 @@ Genome::Genome(
         int genomeSize,
         int k,
         double minLift,
-        double maxLift)
+        double maxLift,
+        RandomStream &random)
 {
     const int parts = 1 << k;
     const int partSize = (genomeSize - 1) / parts;
 
-    double prevLift = minLift + (double) qrand() / RAND_MAX * (maxLift - minLift);
+    double prevLift = minLift + random.uniform() * (maxLift - minLift);
     for (int i = 0; i < parts; ++i)
     {
-        double nextLift = minLift + (double) qrand() / RAND_MAX * (maxLift - minLift);
+        double nextLift = minLift + random.uniform() * (maxLift - minLift);
         for (int j = 0; j < partSize; ++j)
         {
             append(prevLift + (double) j / partSize * (nextLift - prevLift));
@@ -80,22 +82,55 @@ Genome::Genome(
     append(prevLift);
 }
 
+Genome::Genome(
+        int genomeSize,
+        const QVector< double > &knots)
+{
+    const int parts = knots.size() - 1;
+    const int partSize = (genomeSize - 1) / parts;
+
+    for (int i = 0; i < parts; ++i)
+    {
+        for (int j = 0; j < partSize; ++j)
+        {
+            append(knots[i] + (double) j / partSize * (knots[i + 1] - knots[i]));
+        }
+    }
+    append(knots[parts]);
+}
+
+QVector< double > Genome::knots(
+        int k) const
+{
+    const int parts = 1 << k;
+    const int partSize = (size() - 1) / parts;
+
+    QVector< double > result;
+    for (int i = 0; i <= parts; ++i)
+    {
+        result.append(at(i * partSize));
+    }
+
+    return result;
+}
+
 void Genome::mutate(
         int k,
         int kMin,
         double minLift,
-        double maxLift)
+        double maxLift,
+        RandomStream &random)
 {
     const int parts = 1 << k;
     const int partSize = (size() - 1) / parts;
 
-    const int i = qrand() % (parts + 1);
+    const int i = random.bounded(parts + 1);
     const double cl = at(i * partSize);
 
     const double range = maxLift / (1 << (k - kMin));
     const double minr = qMax(minLift - cl, -range);
     const double maxr = qMin(maxLift - cl,  range);
-    const double r = minr + (double) qrand() / RAND_MAX * (maxr - minr);
+    const double r = minr + random.uniform() * (maxr - minr);
 
     if (i > 0)
     {
@@ -138,28 +173,50 @@ void Genome::truncate(
     append(QVector< double >(partSize, last()));
 }
 
-MainWindow::DataPoints Genome::simulate(
+QVector< DataPoint > Genome::simulate(
+        double h,
+        double a,
+        double c,
+        double planformArea,
+        double mass,
+        const DataPoint &dp0,
+        double windowBottom) const
+{
+    Trajectory trajectory;
+    simulate(h, a, c, planformArea, mass, dp0, windowBottom, trajectory);
+    return trajectory.toDataPoints();
+}
+
+void Genome::simulate(
         double h,
         double a,
         double c,
         double planformArea,
         double mass,
         const DataPoint &dp0,
-        double windowBottom)
+        double windowBottom,
+        Trajectory &trajectory,
+        FitnessEvaluator *evaluator) const
 {
     const double velH = sqrt(dp0.vx * dp0.vx + dp0.vy * dp0.vy);
 
-    double t      = dp0.t;
-    double theta  = atan2(-dp0.velD, velH);
-    double v      = sqrt(dp0.velD * dp0.velD + velH * velH);
-    double x      = 0;
-    double y      = dp0.hMSL;
-    double dist2D = dp0.dist2D;
-    double dist3D = dp0.dist3D;
+    Trajectory::State state;
+
+    state.t      = dp0.t;
+    state.theta  = atan2(-dp0.velD, velH);
+    state.v      = sqrt(dp0.velD * dp0.velD + velH * velH);
+    state.x      = 0;
+    state.y      = dp0.hMSL;
+    state.dist2D = dp0.dist2D;
+    state.dist3D = dp0.dist3D;
 
-    MainWindow::DataPoints result(1, dp0);
+    trajectory.start(dp0, state.theta, state.v, size());
+    if (evaluator) evaluator->start(trajectory);
 
-    for (int i = 0; i < size(); ++i)
+    const double yBottom = windowBottom - dp0.z + dp0.hMSL;
+    const double k = planformArea / mass;
+
+    for (int i = 0; i + 1 < size(); ++i)
     {
         const double lift_prev = lift(at(i));
         const double drag_prev = drag(at(i), a, c);
@@ -167,145 +224,49 @@ MainWindow::DataPoints Genome::simulate(
         const double lift_next = lift(at(i + 1));
         const double drag_next = drag(at(i + 1), a, c);
 
+        const double lift_mid = (lift_prev + lift_next) / 2;
+        const double drag_mid = (drag_prev + drag_next) / 2;
+
+        const double theta = state.theta;
+        const double v     = state.v;
+        const double y     = state.y;
+
         // Runge-Kutta integration
         // See https://en.wikipedia.org/wiki/Runge%E2%80%93Kutta_methods
-        const double k0 = h * dtheta_dt(theta, v, x, y, lift_prev, planformArea, mass);
-        const double l0 = h *     dv_dt(theta, v, x, y, drag_prev, planformArea, mass);
-        const double m0 = h *     dx_dt(theta, v, x, y);
-        const double n0 = h *     dy_dt(theta, v, x, y);
-
-        const double k1 = h * dtheta_dt(theta + k0/2, v + l0/2, x + m0/2, y + n0/2, (lift_prev + lift_next) / 2, planformArea, mass);
-        const double l1 = h *     dv_dt(theta + k0/2, v + l0/2, x + m0/2, y + n0/2, (drag_prev + drag_next) / 2, planformArea, mass);
-        const double m1 = h *     dx_dt(theta + k0/2, v + l0/2, x + m0/2, y + n0/2);
-        const double n1 = h *     dy_dt(theta + k0/2, v + l0/2, x + m0/2, y + n0/2);
-
-        const double k2 = h * dtheta_dt(theta + k1/2, v + l1/2, x + m1/2, y + n1/2, (lift_prev + lift_next) / 2, planformArea, mass);
-        const double l2 = h *     dv_dt(theta + k1/2, v + l1/2, x + m1/2, y + n1/2, (drag_prev + drag_next) / 2, planformArea, mass);
-        const double m2 = h *     dx_dt(theta + k1/2, v + l1/2, x + m1/2, y + n1/2);
-        const double n2 = h *     dy_dt(theta + k1/2, v + l1/2, x + m1/2, y + n1/2);
-
-        const double k3 = h * dtheta_dt(theta + k2, v + l2, x + m2, y + n2, lift_next, planformArea, mass);
-        const double l3 = h *     dv_dt(theta + k2, v + l2, x + m2, y + n2, drag_next, planformArea, mass);
-        const double m3 = h *     dx_dt(theta + k2, v + l2, x + m2, y + n2);
-        const double n3 = h *     dy_dt(theta + k2, v + l2, x + m2, y + n2);
+        double k0, l0, m0, n0;
+        derivatives(theta, v, y, lift_prev, drag_prev, k, h, k0, l0, m0, n0);
+
+        double k1, l1, m1, n1;
+        derivatives(theta + k0/2, v + l0/2, y + n0/2, lift_mid, drag_mid, k, h, k1, l1, m1, n1);
+
+        double k2, l2, m2, n2;
+        derivatives(theta + k1/2, v + l1/2, y + n1/2, lift_mid, drag_mid, k, h, k2, l2, m2, n2);
+
+        double k3, l3, m3, n3;
+        derivatives(theta + k2, v + l2, y + n2, lift_next, drag_next, k, h, k3, l3, m3, n3);
 
         const double dtheta = (k0 + 2 * k1 + 2 * k2 + k3) / 6;
         const double dv     = (l0 + 2 * l1 + 2 * l2 + l3) / 6;
         const double dx     = (m0 + 2 * m1 + 2 * m2 + m3) / 6;
         const double dy     = (n0 + 2 * n1 + 2 * n2 + n3) / 6;
 
-        t     += h;
-        theta += dtheta;
-        v     += dv;
-        x     += dx;
-        y     += dy;
-
-        // Add data point
-        DataPoint pt;
-
-        pt.hasGeodetic = false;
-
-        pt.hMSL  = y;
-
-        pt.vx    = 0;
-        pt.vy    = v * cos(theta);
-        pt.velD  = -v * sin(theta);
-
-        pt.t = t;
-        pt.x = x;
-        pt.y = 0;
-        pt.z = y + dp0.z - dp0.hMSL;
-
-        dist2D += dx;
-        dist3D += sqrt(dx * dx + dy * dy);
+        state.t     += h;
+        state.theta += dtheta;
+        state.v     += dv;
+        state.x     += dx;
+        state.y     += dy;
 
-        pt.dist2D = dist2D;
-        pt.dist3D = dist3D;
+        state.dist2D += dx;
+        state.dist3D += sqrt(dx * dx + dy * dy);
 
-        // curv
-        // accel
+        state.lift = lift_next;
+        state.drag = drag_next;
 
-        pt.lift = lift_next;
-        pt.drag = drag_next;
+        trajectory.append(state);
 
-        result.append(pt);
-
-        if (pt.z < windowBottom) break;
+        if (evaluator && !evaluator->add(trajectory)) break;
+        if (state.y < yBottom) break;
     }
-
-    return result;
-}
-
-double Genome::dtheta_dt(
-        double theta,
-        double v,
-        double x,
-        double y,
-        double lift,
-        double planformArea,
-        double mass)
-{
-    // From https://en.wikipedia.org/wiki/Atmospheric_pressure#Altitude_variation
-    const double airPressure = SL_PRESSURE * pow(1 - LAPSE_RATE * y / SL_TEMP, A_GRAVITY * MM_AIR / GAS_CONST / LAPSE_RATE);
-
-    // From https://en.wikipedia.org/wiki/Lapse_rate
-    const double temperature = SL_TEMP - LAPSE_RATE * y;
-
-    // From https://en.wikipedia.org/wiki/Density_of_air
-    const double airDensity = airPressure / (GAS_CONST / MM_AIR) / temperature;
-
-    // From https://en.wikipedia.org/wiki/Dynamic_pressure
-    const double dynamicPressure = airDensity * v * v / 2;
-
-    // Calculate acceleration due to drag and lift
-    const double accelLift = dynamicPressure * planformArea * lift / mass;
-
-    return (accelLift - A_GRAVITY * cos(theta)) / v;
-}
-
-double Genome::dv_dt(
-        double theta,
-        double v,
-        double x,
-        double y,
-        double drag,
-        double planformArea,
-        double mass)
-{
-    // From https://en.wikipedia.org/wiki/Atmospheric_pressure#Altitude_variation
-    const double airPressure = SL_PRESSURE * pow(1 - LAPSE_RATE * y / SL_TEMP, A_GRAVITY * MM_AIR / GAS_CONST / LAPSE_RATE);
-
-    // From https://en.wikipedia.org/wiki/Lapse_rate
-    const double temperature = SL_TEMP - LAPSE_RATE * y;
-
-    // From https://en.wikipedia.org/wiki/Density_of_air
-    const double airDensity = airPressure / (GAS_CONST / MM_AIR) / temperature;
-
-    // From https://en.wikipedia.org/wiki/Dynamic_pressure
-    const double dynamicPressure = airDensity * v * v / 2;
-
-    // Calculate acceleration due to drag and lift
-    const double accelDrag = dynamicPressure * planformArea * drag / mass;
-
-    return -accelDrag - A_GRAVITY * sin(theta);
-}
-
-double Genome::dx_dt(
-        double theta,
-        double v,
-        double x,
-        double y)
-{
-    return v * cos(theta);
-}
-
-double Genome::dy_dt(
-        double theta,
-        double v,
-        double x,
-        double y)
-{
-    return v * sin(theta);
 }
 
 double Genome::lift(
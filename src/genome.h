@@ -26,8 +26,11 @@
 
 #include <QVector>
 
+#include "atmosphere.h"
 #include "datapoint.h"
-#include "mainwindow.h"
+#include "fitnessevaluator.h"
+#include "randomstream.h"
+#include "trajectory.h"
 
 class Genome:
         public QVector< double >
@@ -35,25 +38,66 @@ class Genome:
 public:
     Genome();
     Genome(const QVector< double > &rhs);
-    Genome(const Genome &p1, const Genome &p2, int k);
-    Genome(int genomeSize, int k, double minLift, double maxLift);
+    Genome(const Genome &p1, const Genome &p2, int k, RandomStream &random);
+    Genome(int genomeSize, int k, double minLift, double maxLift,
+           RandomStream &random);
+    Genome(int genomeSize, const QVector< double > &knots);
 
-    void mutate(int k, int kMin, double minLift, double maxLift);
+    // Values at the 2^k + 1 knots of the piecewise linear schedule
+    QVector< double > knots(int k) const;
+
+    void mutate(int k, int kMin, double minLift, double maxLift,
+                RandomStream &random);
     void truncate(int k);
-    MainWindow::DataPoints simulate(double h, double a, double c,
+    QVector< DataPoint > simulate(double h, double a, double c,
                                   double planformArea, double mass,
-                                  const DataPoint &dp0, double windowBottom);
+                                  const DataPoint &dp0, double windowBottom) const;
+    void simulate(double h, double a, double c,
+                  double planformArea, double mass,
+                  const DataPoint &dp0, double windowBottom,
+                  Trajectory &trajectory,
+                  FitnessEvaluator *evaluator = 0) const;
 
 private:
-    static double dtheta_dt(double theta, double v, double x, double y, double lift,
-                            double planformArea, double mass);
-    static double dv_dt(double theta, double v, double x, double y, double drag,
-                        double planformArea, double mass);
-    static double dx_dt(double theta, double v, double x, double y);
-    static double dy_dt(double theta, double v, double x, double y);
+    friend class BatchSimulator;
+
+    static void derivatives(double theta, double v, double y,
+                            double lift, double drag,
+                            double areaPerMass, double h,
+                            double &dtheta, double &dv,
+                            double &dx, double &dy);
 
     static double lift(double cl);
     static double drag(double cl, double a, double c);
 };
 
+inline void Genome::derivatives(
+        double theta,
+        double v,
+        double y,
+        double lift,
+        double drag,
+        double areaPerMass,
+        double h,
+        double &dtheta,
+        double &dv,
+        double &dx,
+        double &dy)
+{
+    // From https://en.wikipedia.org/wiki/Dynamic_pressure
+    const double dynamicPressure = Atmosphere::density(y) * v * v / 2;
+
+    // Calculate acceleration due to drag and lift
+    const double accelLift = dynamicPressure * areaPerMass * lift;
+    const double accelDrag = dynamicPressure * areaPerMass * drag;
+
+    const double cosTheta = cos(theta);
+    const double sinTheta = sin(theta);
+
+    dtheta = h * (accelLift - A_GRAVITY * cosTheta) / v;
+    dv     = h * (-accelDrag - A_GRAVITY * sinTheta);
+    dx     = h * v * cosTheta;
+    dy     = h * v * sinTheta;
+}
+
 #endif // GENOME_H
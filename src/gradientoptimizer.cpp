@@ -0,0 +1,195 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "gradientoptimizer.h"
+
+namespace
+{
+
+const int    maxEvaluations = 75000;    // Budget across all levels of detail
+const int    numInitial     = 100;      // Random schedules to start from
+const int    numSteps       = 4;        // Step sizes tried in each line search
+const double initialStep    = 0.1;      // Step size, relative to lift range
+const double diffStep       = 1e-4;     // Finite difference, relative to lift range
+const double tolX           = 1e-4;     // Smallest step, relative to lift range
+
+} // namespace
+
+GradientOptimizer::GradientOptimizer(
+        FitnessFunction *function,
+        const Parameters &params,
+        QObject *parent):
+    Optimizer(function, params, parent)
+{
+
+}
+
+QVector< DataPoint > GradientOptimizer::optimize()
+{
+    start();
+
+    const int levelBudget = (maxEvaluations - numInitial) / (mKMax - mKMin + 1);
+
+    // Start from the best of a few random schedules
+    GenePool genePool;
+    for (int i = 0; i < numInitial; ++i)
+    {
+        RandomStream random(mParams.seed, 0, i);
+        genePool.append(Score(0, Genome(mGenomeSize, mKMin,
+                                        mParams.minLift, mParams.maxLift,
+                                        random)));
+    }
+
+    evaluate(genePool);
+    setBestScore(genePool);
+    addProgress(numInitial);
+
+    qSort(genePool);
+    Score best = genePool[0];
+
+    // Increasing levels of detail
+    for (int k = mKMin; k <= mKMax && !isCanceled(); ++k)
+    {
+        const int used = optimizeLevel(k, levelBudget, best);
+
+        // Skip whatever is left of this level
+        addProgress(levelBudget - used);
+    }
+
+    return simulate(best.second);
+}
+
+int GradientOptimizer::progressMaximum() const
+{
+    return numInitial + ((maxEvaluations - numInitial) / (mKMax - mKMin + 1)) * (mKMax - mKMin + 1);
+}
+
+int GradientOptimizer::optimizeLevel(
+        int k,
+        int budget,
+        Score &best)
+{
+    const double range = mParams.maxLift - mParams.minLift;
+    const double h = diffStep * range;
+
+    QVector< double > x = best.second.knots(k);
+    double fx = best.first;
+
+    const int n = x.size();
+
+    double alpha = initialStep * range;
+    int used = 0;
+
+    while (used + n + numSteps <= budget && !isCanceled())
+    {
+        // Forward differences, stepping inwards at the upper bound
+        GenePool genePool;
+        QVector< double > diffs(n);
+        for (int j = 0; j < n; ++j)
+        {
+            QVector< double > xj = x;
+            diffs[j] = (x[j] + h <= mParams.maxLift) ? h : -h;
+            xj[j] += diffs[j];
+            genePool.append(Score(0, Genome(mGenomeSize, xj)));
+        }
+
+        evaluate(genePool);
+        setBestScore(genePool);
+
+        used += n;
+        addProgress(n);
+
+        // Project gradient onto the bounds
+        QVector< double > grad(n);
+        double gradMax = 0;
+        for (int j = 0; j < n; ++j)
+        {
+            double g = (genePool[j].first - fx) / diffs[j];
+            if ((x[j] <= mParams.minLift && g < 0) ||
+                (x[j] >= mParams.maxLift && g > 0))
+            {
+                g = 0;
+            }
+
+            grad[j] = g;
+            gradMax = qMax(gradMax, fabs(g));
+        }
+
+        if (gradMax == 0) break;
+
+        // Line search along the scaled gradient
+        GenePool trials;
+        QVector< QVector< double > > points;
+        for (int s = 0; s < numSteps; ++s)
+        {
+            const double step = alpha / (1 << s);
+
+            QVector< double > xs(n);
+            for (int j = 0; j < n; ++j)
+            {
+                xs[j] = qBound(mParams.minLift,
+                               x[j] + step * grad[j] / gradMax,
+                               mParams.maxLift);
+            }
+
+            points.append(xs);
+            trials.append(Score(0, Genome(mGenomeSize, xs)));
+        }
+
+        evaluate(trials);
+        setBestScore(trials);
+
+        used += numSteps;
+        addProgress(numSteps);
+
+        int sBest = -1;
+        for (int s = 0; s < numSteps; ++s)
+        {
+            if (trials[s].first > fx && (sBest < 0 || trials[s].first > trials[sBest].first))
+            {
+                sBest = s;
+            }
+        }
+
+        if (sBest >= 0)
+        {
+            // Accept step and try a longer one next time
+            x = points[sBest];
+            fx = trials[sBest].first;
+            alpha = qMin(range, 2 * alpha / (1 << sBest));
+
+            if (fx > best.first)
+            {
+                best = trials[sBest];
+            }
+        }
+        else
+        {
+            // Try shorter steps
+            alpha /= 1 << numSteps;
+            if (alpha < tolX * range) break;
+        }
+    }
+
+    return used;
+}
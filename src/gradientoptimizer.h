@@ -0,0 +1,48 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef GRADIENTOPTIMIZER_H
+#define GRADIENTOPTIMIZER_H
+
+#include "optimizer.h"
+
+// Projected gradient ascent over the knots of the lift coefficient
+// schedule. Gradients are estimated with forward differences, and each
+// step is chosen with a short line search. Both are scored in parallel.
+// Starts from the best of a set of random schedules and refines from
+// coarse to fine like the genetic optimizer.
+
+class GradientOptimizer : public Optimizer
+{
+public:
+    GradientOptimizer(FitnessFunction *function, const Parameters &params,
+                      QObject *parent = 0);
+
+    QVector< DataPoint > optimize();
+    int progressMaximum() const;
+
+private:
+    int optimizeLevel(int k, int budget, Score &best);
+};
+
+#endif // GRADIENTOPTIMIZER_H
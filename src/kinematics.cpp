@@ -0,0 +1,686 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "kinematics.h"
+
+#include <math.h>
+
+#include <QVarLengthArray>
+
+#include "GeographicLib/Geodesic.hpp"
+
+#include "atmosphere.h"
+#include "common.h"
+
+using namespace GeographicLib;
+
+namespace
+{
+
+// Interval at which running sums are rebuilt around a new time origin
+const int SLOPE_RESEED_INTERVAL = 64;
+
+void setAerodynamics(
+        DataPoint &dp,
+        double accelN,
+        double accelE,
+        double accelD,
+        double mass,
+        double planformArea)
+{
+    // Subtract acceleration due to gravity
+    accelD -= A_GRAVITY;
+
+    // Calculate acceleration due to drag
+    const double vel = DataPoint::totalSpeed(dp);
+    const double proj = (accelN * dp.vy + accelE * dp.vx + accelD * dp.velD) / vel;
+
+    const double dragN = proj * dp.vy / vel;
+    const double dragE = proj * dp.vx / vel;
+    const double dragD = proj * dp.velD / vel;
+
+    const double accelDrag = sqrt(dragN * dragN + dragE * dragE + dragD * dragD);
+
+    // Calculate acceleration due to lift
+    const double liftN = accelN - dragN;
+    const double liftE = accelE - dragE;
+    const double liftD = accelD - dragD;
+
+    const double accelLift = sqrt(liftN * liftN + liftE * liftE + liftD * liftD);
+
+    const double airDensity = Atmosphere::density(dp.hMSL);
+
+    // From https://en.wikipedia.org/wiki/Dynamic_pressure
+    const double dynamicPressure = airDensity * vel * vel / 2;
+
+    // Calculate lift and drag coefficients
+    dp.lift = mass * accelLift / dynamicPressure / planformArea;
+    dp.drag = mass * accelDrag / dynamicPressure / planformArea;
+}
+
+// Distance, heading and relative heading of point i from its position and
+// velocity, and the point before it
+inline void updateMotion(
+        QVector< DataPoint > &data,
+        int i,
+        double theta0,
+        double &dist2D,
+        double &dist3D)
+{
+    DataPoint &dp = data[i];
+
+    // Distance measurements
+    if (i > 0)
+    {
+        const DataPoint &dpPrev = data[i - 1];
+
+        double dx = dp.x - dpPrev.x;
+        double dy = dp.y - dpPrev.y;
+        double dh = sqrt(dx * dx + dy * dy);
+        double dz = dp.hMSL - dpPrev.hMSL;
+
+        dist2D += dh;
+        dist3D += sqrt(dh * dh + dz * dz);
+    }
+
+    dp.dist2D = dist2D;
+    dp.dist3D = dist3D;
+
+    // Calculate heading
+    dp.heading = atan2(dp.vx, dp.vy) / PI * 180;
+
+    // Calculate heading accuracy
+    const double s = DataPoint::totalSpeed(dp);
+    if (s != 0) dp.cAcc = dp.sAcc / s;
+    else        dp.cAcc = 0;
+
+    // Adjust heading to make it cumulative
+    if (i > 0)
+    {
+        const double prevHeading = data[i - 1].heading;
+
+        while (dp.heading <  prevHeading - 180) dp.heading += 360;
+        while (dp.heading >= prevHeading + 180) dp.heading -= 360;
+    }
+
+    // Relative heading
+    dp.theta = dp.heading - theta0;
+}
+
+} // namespace
+
+DataPoint Kinematics::interpolateT(
+        const QVector< DataPoint > &data,
+        double t)
+{
+    const int i1 = findIndexBelowT(data, t);
+    const int i2 = findIndexAboveT(data, t);
+
+    if (i1 < 0)
+    {
+        return data.first();
+    }
+    else if (i2 >= data.size())
+    {
+        return data.last();
+    }
+    else
+    {
+        const DataPoint &dp1 = data[i1];
+        const DataPoint &dp2 = data[i2];
+        return DataPoint::interpolate(dp1, dp2, (t - dp1.t) / (dp2.t - dp1.t));
+    }
+}
+
+int Kinematics::findIndexBelowT(
+        const QVector< DataPoint > &data,
+        double t)
+{
+    int below = -1;
+    int above = data.size();
+
+    while (below + 1 != above)
+    {
+        int mid = (below + above) / 2;
+        const DataPoint &dp = data[mid];
+
+        if (dp.t < t) below = mid;
+        else          above = mid;
+    }
+
+    return below;
+}
+
+int Kinematics::findIndexAboveT(
+        const QVector< DataPoint > &data,
+        double t)
+{
+    int below = -1;
+    int above = data.size();
+
+    while (below + 1 != above)
+    {
+        int mid = (below + above) / 2;
+        const DataPoint &dp = data[mid];
+
+        if (dp.t > t) above = mid;
+        else          below = mid;
+    }
+
+    return above;
+}
+
+void Kinematics::distanceAndBearing(
+        const DataPoint &dp1,
+        const DataPoint &dp2,
+        double &distance,
+        double &bearing)
+{
+    const Geodesic &geod = Geodesic::WGS84();
+    double s12, azi1, azi2;
+
+    if (dp1.hasGeodetic && dp2.hasGeodetic)
+    {
+        // One inversion gives both distance and azimuth
+        geod.Inverse(dp1.lat, dp1.lon, dp2.lat, dp2.lon, s12, azi1, azi2);
+
+        distance = s12;
+    }
+    else
+    {
+        geod.Inverse(dp1.lat, dp1.lon, dp2.lat, dp2.lon, azi1, azi2);
+
+        const double dx = dp2.x - dp1.x;
+        const double dy = dp2.y - dp1.y;
+
+        distance = sqrt(dx * dx + dy * dy);
+    }
+
+    bearing = azi1 / 180 * PI;
+}
+
+qint64 Kinematics::findExit(
+        const QVector< DataPoint > &data,
+        double velD)
+{
+    if (data.isEmpty()) return 0;
+
+    // Searching back from the fastest descent ignores noise on the ground
+    int fastest = 0;
+    for (int i = 1; i < data.size(); ++i)
+    {
+        if (data[i].velD > data[fastest].velD) fastest = i;
+    }
+
+    if (data[fastest].velD >= velD)
+    {
+        for (int i = fastest; i > 0; --i)
+        {
+            const DataPoint &dp1 = data[i - 1];
+            const DataPoint &dp2 = data[i];
+
+            if (dp1.velD < velD)
+            {
+                const qint64 t1 = dp1.dateTime.toMSecsSinceEpoch();
+                const qint64 t2 = dp2.dateTime.toMSecsSinceEpoch();
+                const double a = (velD - dp1.velD) / (dp2.velD - dp1.velD);
+
+                return t1 + qRound64(a * (t2 - t1));
+            }
+        }
+
+        // Already descending when the track starts
+        return data.first().dateTime.toMSecsSinceEpoch();
+    }
+
+    return data.last().dateTime.toMSecsSinceEpoch();
+}
+
+bool Kinematics::fitWind(
+        const QVector< DataPoint > &data,
+        int start,
+        int end,
+        double &windE,
+        double &windN,
+        double &velAircraft)
+{
+    // Weighted least-squares circle fit based on this:
+    //   http://www.dtcenter.org/met/users/docs/write_ups/circle_fit.pdf
+
+    double xbar = 0, ybar = 0, N = 0;
+    for (int i = start; i < end; ++i)
+    {
+        const DataPoint &dp = data[i];
+
+        const double wi = 1.0;
+
+        const double xi = dp.velE;
+        const double yi = dp.velN;
+
+        xbar += wi * xi;
+        ybar += wi * yi;
+
+        N += wi;
+    }
+
+    xbar /= N;
+    ybar /= N;
+
+    double suu = 0, suv = 0, svv = 0;
+    double suuu = 0, suvv = 0, svuu = 0, svvv = 0;
+    for (int i = start; i < end; ++i)
+    {
+        const DataPoint &dp = data[i];
+
+        const double wi = 1.0;
+
+        const double xi = dp.velE;
+        const double yi = dp.velN;
+
+        const double ui = xi - xbar;
+        const double vi = yi - ybar;
+
+        suu += wi * ui * ui;
+        suv += wi * ui * vi;
+        svv += wi * vi * vi;
+
+        suuu += wi * ui * ui * ui;
+        suvv += wi * ui * vi * vi;
+        svuu += wi * vi * ui * ui;
+        svvv += wi * vi * vi * vi;
+    }
+
+    const double det = suu * svv - suv * suv;
+
+    if (det == 0)
+    {
+        windE = 0;
+        windN = 0;
+        velAircraft = 0;
+        return false;
+    }
+
+    const double uc = 1 / det * (0.5 * svv * (suuu + suvv) - 0.5 * suv * (svvv + svuu));
+    const double vc = 1 / det * (0.5 * suu * (svvv + svuu) - 0.5 * suv * (suuu + suvv));
+
+    const double xc = uc + xbar;
+    const double yc = vc + ybar;
+
+    const double alpha = uc * uc + vc * vc + (suu + svv) / N;
+    const double R = sqrt(alpha);
+
+    windE = xc;
+    windN = yc;
+    velAircraft = R;
+
+    return true;
+}
+
+void Kinematics::updateTime(
+        QVector< DataPoint > &data,
+        qint64 exit)
+{
+    for (int i = 0; i < data.size(); ++i)
+    {
+        DataPoint &dp = data[i];
+        dp.t = (double) (dp.dateTime.toMSecsSinceEpoch() - exit) / 1000;
+    }
+}
+
+void Kinematics::updateAltitude(
+        QVector< DataPoint > &data,
+        double ground)
+{
+    for (int i = 0; i < data.size(); ++i)
+    {
+        DataPoint &dp = data[i];
+        dp.z = dp.hMSL - ground;
+    }
+}
+
+void Kinematics::updatePosition(
+        QVector< DataPoint > &data,
+        double windE,
+        double windN,
+        double theta0)
+{
+    if (data.isEmpty()) return;
+
+    // Exit reference is fixed for the whole pass
+    const DataPoint dp0 = interpolateT(data, 0);
+
+    double dist2D = 0, dist3D = 0;
+
+    for (int i = 0; i < data.size(); ++i)
+    {
+        DataPoint &dp = data[i];
+
+        // Wind-adjusted position
+        double distance, bearing;
+        distanceAndBearing(dp0, dp, distance, bearing);
+
+        dp.x = distance * sin(bearing) - windE * dp.t;
+        dp.y = distance * cos(bearing) - windN * dp.t;
+
+        // Wind-adjusted velocity
+        dp.vx = dp.velE - windE;
+        dp.vy = dp.velN - windN;
+
+        updateMotion(data, i, theta0, dist2D, dist3D);
+    }
+}
+
+void Kinematics::updateWind(
+        QVector< DataPoint > &data,
+        double windEOld,
+        double windNOld,
+        double windE,
+        double windN,
+        double theta0)
+{
+    // Wind only enters the position through a term proportional to time,
+    // so the geodesic part doesn't need to be recomputed
+    const double dE = windE - windEOld;
+    const double dN = windN - windNOld;
+
+    double dist2D = 0, dist3D = 0;
+
+    for (int i = 0; i < data.size(); ++i)
+    {
+        DataPoint &dp = data[i];
+
+        // Wind-adjusted position
+        dp.x -= dE * dp.t;
+        dp.y -= dN * dp.t;
+
+        // Wind-adjusted velocity
+        dp.vx = dp.velE - windE;
+        dp.vy = dp.velN - windN;
+
+        updateMotion(data, i, theta0, dist2D, dist3D);
+    }
+}
+
+void Kinematics::updateCourse(
+        QVector< DataPoint > &data,
+        double theta0)
+{
+    for (int i = 0; i < data.size(); ++i)
+    {
+        DataPoint &dp = data[i];
+        dp.theta = dp.heading - theta0;
+    }
+}
+
+void Kinematics::getSlopes(
+        const double *t,
+        const double *const *y,
+        double *const *slopes,
+        int numChannels,
+        int count,
+        int halfWidth)
+{
+    QVarLengthArray< double, 8 > sumy(numChannels), sumxy(numChannels);
+    double t0 = 0, sumx = 0, sumxx = 0;
+
+    // Samples currently included in the sums
+    int lo = 0, hi = -1;
+
+    for (int center = 0; center < count; ++center)
+    {
+        const int iMin = qMax(0, center - halfWidth);
+        const int iMax = qMin(count - 1, center + halfWidth);
+
+        if (center % SLOPE_RESEED_INTERVAL == 0)
+        {
+            // Rebuild sums relative to a nearby origin to limit rounding
+            // drift and cancellation in the denominator
+            t0 = t[center];
+            sumx = sumxx = 0;
+
+            for (int j = 0; j < numChannels; ++j)
+            {
+                sumy[j] = sumxy[j] = 0;
+            }
+
+            lo = iMin;
+            hi = iMin - 1;
+        }
+
+        // Add samples entering the window
+        while (hi < iMax)
+        {
+            ++hi;
+
+            const double x = t[hi] - t0;
+
+            sumx += x;
+            sumxx += x * x;
+
+            for (int j = 0; j < numChannels; ++j)
+            {
+                sumy[j] += y[j][hi];
+                sumxy[j] += x * y[j][hi];
+            }
+        }
+
+        // Remove samples leaving the window
+        while (lo < iMin)
+        {
+            const double x = t[lo] - t0;
+
+            sumx -= x;
+            sumxx -= x * x;
+
+            for (int j = 0; j < numChannels; ++j)
+            {
+                sumy[j] -= y[j][lo];
+                sumxy[j] -= x * y[j][lo];
+            }
+
+            ++lo;
+        }
+
+        const int n = hi - lo + 1;
+        const double den = sumxx - sumx * sumx / n;
+
+        for (int j = 0; j < numChannels; ++j)
+        {
+            slopes[j][center] = (sumxy[j] - sumx * sumy[j] / n) / den;
+        }
+    }
+}
+
+void Kinematics::updateDerivatives(
+        QVector< DataPoint > &data,
+        double mass,
+        double planformArea,
+        int halfWidth)
+{
+    enum { Dive, Speed, Course, VelN, VelE, VelD, NumChannels };
+
+    const int n = data.size();
+
+    // Sample each channel once into contiguous arrays
+    QVector< double > t(n);
+    QVector< double > values(NumChannels * n), slopes(NumChannels * n);
+
+    double *y[NumChannels], *dy[NumChannels];
+    for (int j = 0; j < NumChannels; ++j)
+    {
+        y[j] = values.data() + j * n;
+        dy[j] = slopes.data() + j * n;
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        const DataPoint &dp = data[i];
+
+        t[i] = dp.t;
+        y[Dive][i] = DataPoint::diveAngle(dp);
+        y[Speed][i] = DataPoint::totalSpeed(dp);
+        y[Course][i] = DataPoint::course(dp);
+        y[VelN][i] = DataPoint::northSpeed(dp);
+        y[VelE][i] = DataPoint::eastSpeed(dp);
+        y[VelD][i] = DataPoint::verticalSpeed(dp);
+    }
+
+    getSlopes(t.constData(), y, dy, NumChannels, n, halfWidth);
+
+    for (int i = 0; i < n; ++i)
+    {
+        DataPoint &dp = data[i];
+
+        // Parameters depending on velocity
+        dp.curv = dy[Dive][i];
+        dp.accel = dy[Speed][i];
+        dp.omega = dy[Course][i];
+
+        // Aerodynamics
+        setAerodynamics(dp, dy[VelN][i], dy[VelE][i], dy[VelD][i],
+                        mass, planformArea);
+    }
+}
+
+void Kinematics::updateAerodynamics(
+        QVector< DataPoint > &data,
+        double mass,
+        double planformArea,
+        int halfWidth)
+{
+    enum { VelN, VelE, VelD, NumChannels };
+
+    const int n = data.size();
+
+    QVector< double > t(n);
+    QVector< double > values(NumChannels * n), slopes(NumChannels * n);
+
+    double *y[NumChannels], *dy[NumChannels];
+    for (int j = 0; j < NumChannels; ++j)
+    {
+        y[j] = values.data() + j * n;
+        dy[j] = slopes.data() + j * n;
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        const DataPoint &dp = data[i];
+
+        t[i] = dp.t;
+        y[VelN][i] = DataPoint::northSpeed(dp);
+        y[VelE][i] = DataPoint::eastSpeed(dp);
+        y[VelD][i] = DataPoint::verticalSpeed(dp);
+    }
+
+    getSlopes(t.constData(), y, dy, NumChannels, n, halfWidth);
+
+    for (int i = 0; i < n; ++i)
+    {
+        setAerodynamics(data[i], dy[VelN][i], dy[VelE][i], dy[VelD][i],
+                        mass, planformArea);
+    }
+}
+
+int Kinematics::changedStages(
+        const Parameters &from,
+        const Parameters &to)
+{
+    int stages = 0;
+
+    if (from.exit != to.exit) stages |= Time;
+    if (from.ground != to.ground) stages |= Altitude;
+    if (from.windE != to.windE || from.windN != to.windN) stages |= Position;
+    if (from.course != to.course) stages |= Course;
+    if (from.halfWidth != to.halfWidth) stages |= Derivatives;
+    if (from.mass != to.mass || from.planformArea != to.planformArea) stages |= Aerodynamics;
+
+    return downstreamStages(stages);
+}
+
+int Kinematics::downstreamStages(
+        int stages)
+{
+    // Stages are listed in dependency order, so one pass is enough
+    if (stages & Time)        stages |= Position | Derivatives;
+    if (stages & Position)    stages |= Course | Derivatives;
+    if (stages & Derivatives) stages |= Aerodynamics;
+
+    return stages;
+}
+
+void Kinematics::initialize(
+        QVector< DataPoint > &data,
+        const Parameters &params)
+{
+    updateTime(data, params.exit);
+    updateAltitude(data, params.ground);
+    updatePosition(data, params.windE, params.windN, params.course);
+    updateDerivatives(data, params.mass, params.planformArea, params.halfWidth);
+}
+
+int Kinematics::update(
+        QVector< DataPoint > &data,
+        const Parameters &from,
+        const Parameters &to)
+{
+    const int stages = changedStages(from, to);
+
+    if (stages & Time)
+    {
+        updateTime(data, to.exit);
+    }
+
+    if (stages & Altitude)
+    {
+        updateAltitude(data, to.ground);
+    }
+
+    if (stages & Position)
+    {
+        if (stages & Time)
+        {
+            // Exit reference moved, so positions start from scratch
+            updatePosition(data, to.windE, to.windN, to.course);
+        }
+        else
+        {
+            updateWind(data, from.windE, from.windN, to.windE, to.windN,
+                       to.course);
+        }
+    }
+    else if (stages & Course)
+    {
+        updateCourse(data, to.course);
+    }
+
+    if (stages & Derivatives)
+    {
+        updateDerivatives(data, to.mass, to.planformArea, to.halfWidth);
+    }
+    else if (stages & Aerodynamics)
+    {
+        updateAerodynamics(data, to.mass, to.planformArea, to.halfWidth);
+    }
+
+    return stages;
+}
@@ -0,0 +1,113 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include <QVector>
+
+#include "datapoint.h"
+
+namespace Kinematics
+{
+    DataPoint interpolateT(const QVector< DataPoint > &data, double t);
+    int findIndexBelowT(const QVector< DataPoint > &data, double t);
+    int findIndexAboveT(const QVector< DataPoint > &data, double t);
+
+    void distanceAndBearing(const DataPoint &dp1, const DataPoint &dp2,
+                            double &distance, double &bearing);
+
+    // Time (ms since epoch) at which vertical speed last rose through velD
+    // before the fastest descent. Falls back to the end of the track, as
+    // when no exit has been set, if velD is never reached.
+    qint64 findExit(const QVector< DataPoint > &data, double velD);
+
+    // Least-squares circle fit to horizontal velocity over [start, end),
+    // giving wind and airspeed. Returns false, with all three zero, if the
+    // velocities do not define a circle.
+    bool fitWind(const QVector< DataPoint > &data, int start, int end,
+                 double &windE, double &windN, double &velAircraft);
+
+    // Track parameters which derived channels depend on
+    typedef struct {
+        qint64 exit;            // Exit time (ms since epoch)
+        double ground;          // Ground elevation (m)
+        double windE, windN;    // Wind used to adjust position (m/s)
+        double course;          // Reference heading (deg)
+        double mass;            // Jumper mass (kg)
+        double planformArea;    // Planform area (m^2)
+        int    halfWidth;       // Half-width of slope window (samples)
+    } Parameters;
+
+    // Groups of derived channels, in dependency order
+    typedef enum {
+        Time         = 0x01,    // t
+        Altitude     = 0x02,    // z
+        Position     = 0x04,    // x, y, vx, vy, dist2D, dist3D, heading, cAcc
+        Course       = 0x08,    // theta
+        Derivatives  = 0x10,    // curv, accel, omega
+        Aerodynamics = 0x20     // lift, drag
+    } Stage;
+
+    // Stages affected by a change in parameters, including those downstream
+    int changedStages(const Parameters &from, const Parameters &to);
+    int downstreamStages(int stages);
+
+    // Compute all derived channels
+    void initialize(QVector< DataPoint > &data, const Parameters &params);
+
+    // Recompute only the channels affected by a change in parameters and
+    // return the stages which were updated
+    int update(QVector< DataPoint > &data, const Parameters &from,
+               const Parameters &to);
+
+    void updateTime(QVector< DataPoint > &data, qint64 exit);
+    void updateAltitude(QVector< DataPoint > &data, double ground);
+
+    // Position, velocity, distance and heading in a single pass
+    void updatePosition(QVector< DataPoint > &data, double windE, double windN,
+                        double theta0);
+
+    // Same as updatePosition, starting from positions computed with
+    // another wind
+    void updateWind(QVector< DataPoint > &data, double windEOld,
+                    double windNOld, double windE, double windN,
+                    double theta0);
+
+    void updateCourse(QVector< DataPoint > &data, double theta0);
+
+    // Least-squares slopes of several channels over a sliding window of
+    // 2 * halfWidth + 1 samples, using running sums
+    void getSlopes(const double *t, const double *const *y,
+                   double *const *slopes, int numChannels, int count,
+                   int halfWidth);
+
+    // Slope-derived parameters and aerodynamics in a single pass
+    void updateDerivatives(QVector< DataPoint > &data, double mass,
+                           double planformArea, int halfWidth);
+
+    void updateAerodynamics(QVector< DataPoint > &data, double mass,
+                            double planformArea, int halfWidth);
+}
+
+#endif // KINEMATICS_H
@@ -27,6 +27,7 @@
 #include "common.h"
 #include "liftdragplot.h"
 #include "mainwindow.h"
+#include "profiler.h"
 
 LiftDragPlot::LiftDragPlot(QWidget *parent) :
     QCustomPlot(parent),
@@ -158,6 +159,8 @@ void LiftDragPlot::setMark(
 
 void LiftDragPlot::updatePlot()
 {
+    ProfileScope scope("LiftDragPlot::updatePlot");
+
     clearPlottables();
     clearItems();
 
@@ -33,6 +33,7 @@
 #include <QSqlRecord>
 
 #include "mainwindow.h"
+#include "profiler.h"
 
 class RealItem : public QTableWidgetItem
 {
@@ -115,6 +116,8 @@ void LogbookView::setMainWindow(
 
 void LogbookView::updateView()
 {
+    ProfileScope scope("LogbookView::updateView");
+
     suspendItemChanged = true;
 
     ui->tableWidget->setSortingEnabled(false);
@@ -26,20 +26,23 @@
 
 #include <QCryptographicHash>
 #include <QDockWidget>
+#include <QEventLoop>
 #include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QMessageBox>
 #include <QProgressDialog>
+#include <QSaveFile>
 #include <QSettings>
 #include <QShortcut>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QStandardPaths>
-#include <QTemporaryFile>
 #include <QTextStream>
 #include <QThread>
+#include <QtConcurrent>
 
 #include <math.h>
 
@@ -50,15 +53,23 @@
 #include "dataview.h"
 #include "flarescoring.h"
 #include "importworker.h"
+#include "kinematics.h"
 #include "liftdragplot.h"
 #include "logbookview.h"
 #include "mapview.h"
 #include "orthoview.h"
 #include "performancescoring.h"
+#include "performanceview.h"
 #include "playbackview.h"
 #include "ppcscoring.h"
+#include "profiler.h"
+#include "refreshscheduler.h"
+#include "scoringrules.h"
 #include "scoringview.h"
 #include "speedscoring.h"
+#include "trackimport.h"
+#include "trackparser.h"
+#include "trackstore.h"
 #include "videoview.h"
 #include "wideopendistancescoring.h"
 #include "wideopenspeedscoring.h"
@@ -78,18 +89,22 @@ MainWindow::MainWindow(
     mScoringView(0),
     m_mass(70),
     m_planformArea(2),
+    m_slopeWindow(5),
     m_minDrag(0.05),
     m_minLift(0.0),
     m_maxLift(0.5),
     m_maxLD(3.0),
     m_simulationTime(120),
+    m_batchSimulation(true),
+    m_optimizationAlgorithm(Genetic),
     mLineThickness(0),
     mWindE(0),
     mWindN(0),
     mWindAdjustment(false),
     mScoringMode(PPC),
     mGroundReference(Automatic),
-    mFixedReference(0)
+    mFixedReference(0),
+    mTrackCacheSize(256)
 {
     m_ui->setupUi(this);
 
@@ -121,9 +136,22 @@ MainWindow::MainWindow(
     // Read settings
     readSettings();
 
+    // Set track cache budget
+    mTrackCache.setBudget((qint64) mTrackCacheSize * 1024 * 1024);
+
     // Initialize database
     initDatabase();
 
+    // Views are refreshed together once per frame
+    mRefreshScheduler = new RefreshScheduler(this);
+
+    connect(this, SIGNAL(dataChanged()),
+            mRefreshScheduler, SLOT(setDataChanged()));
+    connect(this, SIGNAL(rangeChanged()),
+            mRefreshScheduler, SLOT(setRangeChanged()));
+    connect(this, SIGNAL(cursorChanged()),
+            mRefreshScheduler, SLOT(setCursorChanged()));
+
     // Intitialize plot area
     initPlot();
 
@@ -149,6 +177,9 @@ MainWindow::MainWindow(
     // Initialize logbook view
     initLogbookView();
 
+    // Initialize performance view
+    initPerformanceView();
+
     // Restore window state
     QSettings settings("FlySight", "Viewer");
     settings.beginGroup("mainWindow");
@@ -201,11 +232,14 @@ void MainWindow::writeSettings()
         settings.setValue("units", m_units);
         settings.setValue("mass", m_mass);
         settings.setValue("planformArea", m_planformArea);
+        settings.setValue("slopeWindow", m_slopeWindow);
         settings.setValue("minDrag", m_minDrag);
         settings.setValue("minLift", m_minLift);
         settings.setValue("maxLift", m_maxLift);
         settings.setValue("maxLD", m_maxLD);
         settings.setValue("simulationTime", m_simulationTime);
+        settings.setValue("batchSimulation", m_batchSimulation);
+        settings.setValue("optimizationAlgorithm", m_optimizationAlgorithm);
         settings.setValue("lineThickness", mLineThickness);
         settings.setValue("windE", mWindE);
         settings.setValue("windN", mWindN);
@@ -213,6 +247,7 @@ void MainWindow::writeSettings()
         settings.setValue("groundReference", mGroundReference);
         settings.setValue("fixedReference", mFixedReference);
         settings.setValue("databasePath", mDatabasePath);
+        settings.setValue("trackCacheSize", mTrackCacheSize);
     settings.endGroup();
 }
 
@@ -224,11 +259,14 @@ void MainWindow::readSettings()
         m_units = (PlotValue::Units) settings.value("units", m_units).toInt();
         m_mass = settings.value("mass", m_mass).toDouble();
         m_planformArea = settings.value("planformArea", m_planformArea).toDouble();
+        m_slopeWindow = settings.value("slopeWindow", m_slopeWindow).toInt();
         m_minDrag = settings.value("minDrag", m_minDrag).toDouble();
         m_minLift = settings.value("minLift", m_minLift).toDouble();
         m_maxLift = settings.value("maxLift", m_maxLift).toDouble();
         m_maxLD = settings.value("maxLD", m_maxLD).toDouble();
         m_simulationTime = settings.value("simulationTime", m_simulationTime).toInt();
+        m_batchSimulation = settings.value("batchSimulation", m_batchSimulation).toBool();
+        m_optimizationAlgorithm = (OptimizationAlgorithm) settings.value("optimizationAlgorithm", m_optimizationAlgorithm).toInt();
         mLineThickness = settings.value("lineThickness", mLineThickness).toDouble();
         mWindE = settings.value("windE", mWindE).toDouble();
         mWindN = settings.value("windN", mWindN).toDouble();
@@ -238,12 +276,17 @@ void MainWindow::readSettings()
         mDatabasePath = settings.value("databasePath",
                                        QStandardPaths::writableLocation(
                                            QStandardPaths::DocumentsLocation)).toString();
+        mTrackCacheSize = settings.value("trackCacheSize", mTrackCacheSize).toInt();
     settings.endGroup();
 }
 
 void MainWindow::initDatabase()
 {
     QDir(mDatabasePath).mkpath("FlySight");
+
+    // Cached tracks belong to the previous logbook
+    mTrackCache.setDatabasePath(mDatabasePath);
+
     QString path = QDir(mDatabasePath).filePath("FlySight/FlySight.db");
 
     mDatabase = QSqlDatabase::addDatabase("QSQLITE", "flysight");
@@ -300,12 +343,12 @@ void MainWindow::initPlot()
 
     m_ui->plotArea->setMainWindow(this);
 
+    // Columns are dropped right away, although the plot is redrawn later
     connect(this, SIGNAL(dataChanged()),
-            m_ui->plotArea, SLOT(updatePlot()));
-    connect(this, SIGNAL(rangeChanged()),
-            m_ui->plotArea, SLOT(updateRange()));
-    connect(this, SIGNAL(cursorChanged()),
-            m_ui->plotArea, SLOT(updateCursor()));
+            m_ui->plotArea, SLOT(clearColumns()));
+
+    mRefreshScheduler->addView(m_ui->plotArea,
+                               "updatePlot", "updateRange", "updateCursor");
 }
 
 void MainWindow::initViews()
@@ -335,12 +378,8 @@ void MainWindow::initSingleView(
     connect(dockWidget, SIGNAL(visibilityChanged(bool)),
             actionShow, SLOT(setChecked(bool)));
 
-    connect(this, SIGNAL(dataChanged()),
-            dataView, SLOT(updateView()));
-    connect(this, SIGNAL(rangeChanged()),
-            dataView, SLOT(updateView()));
-    connect(this, SIGNAL(cursorChanged()),
-            dataView, SLOT(updateCursor()));
+    mRefreshScheduler->addView(dataView,
+                               "updateView", "updateView", "updateCursor");
     connect(this, SIGNAL(rotationChanged(double)),
             dataView, SLOT(updateView()));
 }
@@ -362,12 +401,8 @@ void MainWindow::initMapView()
 
     connect(this, SIGNAL(dataLoaded()),
             mapView, SLOT(initView()));
-    connect(this, SIGNAL(dataChanged()),
-            mapView, SLOT(updateView()));
-    connect(this, SIGNAL(rangeChanged()),
-            mapView, SLOT(updateView()));
-    connect(this, SIGNAL(cursorChanged()),
-            mapView, SLOT(updateView()));
+    mRefreshScheduler->addView(mapView,
+                               "updateView", "updateView", "updateView");
 }
 
 void MainWindow::initWindView()
@@ -386,12 +421,8 @@ void MainWindow::initWindView()
     connect(dockWidget, SIGNAL(visibilityChanged(bool)),
             m_ui->actionShowWindView, SLOT(setChecked(bool)));
 
-    connect(this, SIGNAL(dataChanged()),
-            windPlot, SLOT(updatePlot()));
-    connect(this, SIGNAL(rangeChanged()),
-            windPlot, SLOT(updatePlot()));
-    connect(this, SIGNAL(cursorChanged()),
-            windPlot, SLOT(updatePlot()));
+    mRefreshScheduler->addView(windPlot,
+                               "updatePlot", "updatePlot", "updatePlot");
 }
 
 void MainWindow::initScoringView()
@@ -412,10 +443,8 @@ void MainWindow::initScoringView()
     connect(dockWidget, SIGNAL(visibilityChanged(bool)),
             m_ui->actionShowScoringView, SLOT(setChecked(bool)));
 
-    connect(this, SIGNAL(dataChanged()),
-            mScoringView, SLOT(updateView()));
-    connect(this, SIGNAL(rangeChanged()),
-            mScoringView, SLOT(updateView()));
+    mRefreshScheduler->addView(mScoringView,
+                               "updateView", "updateView", 0);
 }
 
 void MainWindow::initLiftDragView()
@@ -434,12 +463,8 @@ void MainWindow::initLiftDragView()
     connect(dockWidget, SIGNAL(visibilityChanged(bool)),
             m_ui->actionShowLiftDragView, SLOT(setChecked(bool)));
 
-    connect(this, SIGNAL(dataChanged()),
-            liftDragPlot, SLOT(updatePlot()));
-    connect(this, SIGNAL(rangeChanged()),
-            liftDragPlot, SLOT(updatePlot()));
-    connect(this, SIGNAL(cursorChanged()),
-            liftDragPlot, SLOT(updatePlot()));
+    mRefreshScheduler->addView(liftDragPlot,
+                               "updatePlot", "updatePlot", "updatePlot");
     connect(this, SIGNAL(aeroChanged()),
             liftDragPlot, SLOT(updatePlot()));
 }
@@ -460,12 +485,8 @@ void MainWindow::initOrthoView()
     connect(dockWidget, SIGNAL(visibilityChanged(bool)),
             m_ui->actionShowOrthoView, SLOT(setChecked(bool)));
 
-    connect(this, SIGNAL(dataChanged()),
-            orthoView, SLOT(updateView()));
-    connect(this, SIGNAL(rangeChanged()),
-            orthoView, SLOT(updateView()));
-    connect(this, SIGNAL(cursorChanged()),
-            orthoView, SLOT(updateView()));
+    mRefreshScheduler->addView(orthoView,
+                               "updateView", "updateView", "updateView");
 }
 
 void MainWindow::initPlaybackView()
@@ -484,6 +505,7 @@ void MainWindow::initPlaybackView()
     connect(dockWidget, SIGNAL(visibilityChanged(bool)),
             m_ui->actionShowPlaybackView, SLOT(setChecked(bool)));
 
+    // Playback moves the mark itself, so it is kept in step directly
     connect(this, SIGNAL(dataChanged()),
             playbackView, SLOT(updateView()));
     connect(this, SIGNAL(rangeChanged()),
@@ -513,6 +535,21 @@ void MainWindow::initLogbookView()
             logbookView, SLOT(updateView()));
 }
 
+void MainWindow::initPerformanceView()
+{
+    PerformanceView *performanceView = new PerformanceView;
+    QDockWidget *dockWidget = new QDockWidget(tr("Performance"));
+    dockWidget->setWidget(performanceView);
+    dockWidget->setObjectName("performanceView");
+    dockWidget->setVisible(false);
+    addDockWidget(Qt::BottomDockWidgetArea, dockWidget);
+
+    connect(m_ui->actionShowPerformanceView, SIGNAL(toggled(bool)),
+            dockWidget, SLOT(setVisible(bool)));
+    connect(dockWidget, SIGNAL(visibilityChanged(bool)),
+            m_ui->actionShowPerformanceView, SLOT(setChecked(bool)));
+}
+
 void MainWindow::closeEvent(
         QCloseEvent *event)
 {
@@ -532,72 +569,24 @@ void MainWindow::closeEvent(
 DataPoint MainWindow::interpolateDataT(
         double t)
 {
-    const int i1 = findIndexBelowT(t);
-    const int i2 = findIndexAboveT(t);
-
-    if (i1 < 0)
-    {
-        return m_data.first();
-    }
-    else if (i2 >= m_data.size())
-    {
-        return m_data.last();
-    }
-    else
-    {
-        const DataPoint &dp1 = m_data[i1];
-        const DataPoint &dp2 = m_data[i2];
-        return DataPoint::interpolate(dp1, dp2, (t - dp1.t) / (dp2.t - dp1.t));
-    }
+    return mTrack.interpolateT(t);
 }
 
 int MainWindow::findIndexBelowT(
         double t)
 {
-    int below = -1;
-    int above = m_data.size();
-
-    while (below + 1 != above)
-    {
-        int mid = (below + above) / 2;
-        const DataPoint &dp = m_data[mid];
-
-        if (dp.t < t) below = mid;
-        else          above = mid;
-    }
-
-    return below;
+    return mTrack.findIndexBelowT(t);
 }
 
 int MainWindow::findIndexAboveT(
         double t)
 {
-    int below = -1;
-    int above = m_data.size();
-
-    while (below + 1 != above)
-    {
-        int mid = (below + above) / 2;
-        const DataPoint &dp = m_data[mid];
-
-        if (dp.t > t) above = mid;
-        else          below = mid;
-    }
-
-    return above;
+    return mTrack.findIndexAboveT(t);
 }
 
 int MainWindow::findIndexForLanding()
 {
-    int i = findIndexBelowT(0.0);
-
-    while (++i < m_data.size()-1) {
-        const DataPoint &p = m_data[i];
-        if (p.velE*p.velE + p.velN*p.velN + p.velD < 1.0)
-            break;
-    }
-
-    return i;
+    return mTrack.findIndexForLanding();
 }
 
 void MainWindow::on_actionImport_triggered()
@@ -614,10 +603,13 @@ void MainWindow::on_actionImport_triggered()
     // Sort files from oldest to newest
     qSort(fileNames);
 
-    // Import each file
-    foreach (QString fileName, fileNames)
+    if (fileNames.size() == 1)
+    {
+        importFile(fileNames.front());
+    }
+    else
     {
-        importFile(fileName);
+        importFiles(fileNames);
     }
 }
 
@@ -638,42 +630,182 @@ void MainWindow::on_actionImportFolder_triggered()
 
 void MainWindow::importFolder(
         QString folderName)
+{
+    QStringList fileNames;
+    findFiles(folderName, fileNames);
+
+    // Import all files at once
+    importFiles(fileNames);
+}
+
+void MainWindow::findFiles(
+        QString folderName,
+        QStringList &fileNames)
 {
     QDir dir(folderName);
 
-    // Import each file in this folder
+    // Add each file in this folder
     foreach (QString fileName, dir.entryList(QStringList() << "*.csv",
                                              QDir::Files,
                                              QDir::Name))
     {
-        importFile(dir.absoluteFilePath(fileName));
+        fileNames.append(dir.absoluteFilePath(fileName));
     }
 
     // Follow subfolders
     foreach (QString child, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot,
                                           QDir::Name))
     {
-        importFolder(dir.absoluteFilePath(child));
+        findFiles(dir.absoluteFilePath(child), fileNames);
     }
 }
 
-void MainWindow::importFile(
-        QString fileName)
+void MainWindow::importFiles(
+        QStringList fileNames)
 {
+    if (fileNames.isEmpty()) return;
+
     // Initialize settings object
     QSettings settings("FlySight", "Viewer");
 
     // Remember last file read
-    settings.setValue("folder", QFileInfo(fileName).absoluteFilePath());
+    settings.setValue("folder", QFileInfo(fileNames.last()).absoluteFilePath());
+
+    QProgressDialog progress(tr("Importing tracks..."),
+                             tr("Abort"),
+                             0,
+                             fileNames.size(),
+                             this);
+    progress.setWindowModality(Qt::WindowModal);
+
+    // Hash, parse and store files on the thread pool
+    QFutureWatcher< TrackImport::Result > watcher;
+    QEventLoop loop;
+
+    connect(&watcher, SIGNAL(progressValueChanged(int)),
+            &progress, SLOT(setValue(int)));
+    connect(&progress, SIGNAL(canceled()),
+            &watcher, SLOT(cancel()));
+    connect(&watcher, SIGNAL(finished()),
+            &loop, SLOT(quit()));
+
+    watcher.setFuture(QtConcurrent::mapped(fileNames, TrackImport::Task(mDatabasePath)));
+    loop.exec();
+
+    const QFuture< TrackImport::Result > future = watcher.future();
+
+    // Add all new files to the database in a single transaction
+    const QString importTime = dateTimeToUTC(QDateTime::currentDateTime());
+
+    QSqlQuery query(mDatabase);
+    mDatabase.transaction();
+
+    QString lastName;
+    QStringList errors;
 
-    // Create temporary file
-    QTemporaryFile temporaryFile;
-    if (!temporaryFile.open())
+    for (int i = 0; i < fileNames.size(); ++i)
+    {
+        if (!future.isResultReadyAt(i)) continue;
+
+        const TrackImport::Result result = future.resultAt(i);
+        if (!result.valid || !result.stored)
+        {
+            errors.append(QString("%1: %2")
+                          .arg(QDir::toNativeSeparators(result.fileName))
+                          .arg(result.error));
+            continue;
+        }
+
+        lastName = result.uniqueName;
+
+        // Check if the file is in the database
+        if (!query.exec(QString("select * from files where file_name='%1'")
+                        .arg(result.uniqueName)))
+        {
+            QSqlError err = query.lastError();
+            QMessageBox::critical(0, tr("Query failed"), err.text());
+            mDatabase.rollback();
+            return;
+        }
+
+        if (query.next()) continue;
+
+        const TrackImport::Summary &summary = result.summary;
+
+        // Same defaults as trackParameters
+        const double ground = (mGroundReference == Automatic) ? summary.endHMSL
+                                                              : mFixedReference;
+
+        if (!query.exec(QString("insert into files ("
+                                "file_name, "
+                                "description, "
+                                "start_time, "
+                                "duration, "
+                                "sample_period, "
+                                "min_lat, "
+                                "max_lat, "
+                                "min_lon, "
+                                "max_lon, "
+                                "import_time, "
+                                "exit, "
+                                "ground, "
+                                "course, "
+                                "wind_e, "
+                                "wind_n) "
+                                "values ('%1', '', '%2', %3, %4, %5, %6, %7, %8, "
+                                "'%9', '%10', '%11', '%12', '%13', '%14')")
+                        .arg(result.uniqueName)
+                        .arg(dateTimeToUTC(summary.startTime))
+                        .arg(summary.duration)
+                        .arg(summary.samplePeriod)
+                        .arg(summary.minLat)
+                        .arg(summary.maxLat)
+                        .arg(summary.minLon)
+                        .arg(summary.maxLon)
+                        .arg(importTime)
+                        .arg(dateTimeToUTC(summary.endTime))
+                        .arg(QString::number(ground, 'f', 3))
+                        .arg(QString::number(0.0, 'f', 5))
+                        .arg(QString::number(mWindE, 'f', 2))
+                        .arg(QString::number(mWindN, 'f', 2))))
+        {
+            QSqlError err = query.lastError();
+            QMessageBox::critical(0, tr("Query failed"), err.text());
+            mDatabase.rollback();
+            return;
+        }
+    }
+
+    if (!mDatabase.commit())
     {
-        QMessageBox::critical(0, tr("Import failed"), tr("Couldn't create temporary file"));
+        QSqlError err = mDatabase.lastError();
+        QMessageBox::critical(0, tr("Query failed"), err.text());
         return;
     }
 
+    emit databaseChanged();
+
+    if (!errors.isEmpty())
+    {
+        QMessageBox::warning(0, tr("Import failed"), errors.join("\n"));
+    }
+
+    // Show the last track imported
+    if (!lastName.isEmpty())
+    {
+        importFromDatabase(lastName);
+    }
+}
+
+void MainWindow::importFile(
+        QString fileName)
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Viewer");
+
+    // Remember last file read
+    settings.setValue("folder", QFileInfo(fileName).absoluteFilePath());
+
     QFile file(fileName);
     if (!file.open(QIODevice::ReadOnly))
     {
@@ -681,22 +813,20 @@ void MainWindow::importFile(
         return;
     }
 
-    // Copy to temporary file
-    temporaryFile.write(file.readAll());
-    file.close();
-
-    // Get hash
-    QCryptographicHash hash(QCryptographicHash::Md5);
-
-    temporaryFile.seek(0);
-    if (!hash.addData(&temporaryFile))
+    // Read the source once and share it between hash, parser and store
+    TrackParser::MappedFile mapped(&file);
+    if (!mapped.isValid())
     {
-        QMessageBox::critical(0, tr("Import failed"), tr("Couldn't generate hash"));
+        QMessageBox::critical(0, tr("Import failed"), tr("Couldn't read file"));
         return;
     }
 
+    // Get hash
+    const QByteArray bytes = QByteArray::fromRawData(mapped.begin(), mapped.size());
+    const QByteArray hash = QCryptographicHash::hash(bytes, QCryptographicHash::Md5);
+
     // Get name of file in database
-    QString uniqueName = QString(hash.result().toHex());
+    QString uniqueName = QString(hash.toHex());
     QString newName = QString("FlySight/Tracks/%1.csv").arg(uniqueName);
     QString newPath = QDir(mDatabasePath).filePath(newName);
 
@@ -725,8 +855,7 @@ void MainWindow::importFile(
     }
 
     // Read file data
-    temporaryFile.seek(0);
-    import(&temporaryFile, m_data, uniqueName, true);
+    import(mapped.begin(), mapped.end(), uniqueName, true);
 
     // Clear optimum
     m_optimal.clear();
@@ -741,32 +870,14 @@ void MainWindow::importFile(
     {
         QDir(mDatabasePath).mkpath("FlySight/Tracks");
 
-        if (temporaryFile.copy(newPath))
+        // Write the source straight into the track store
+        QSaveFile newFile(newPath);
+        if (newFile.open(QIODevice::WriteOnly)
+                && newFile.write(mapped.begin(), mapped.size()) == mapped.size()
+                && newFile.commit())
         {
-            QDateTime startTime = m_data.front().dateTime;
-            qint64 duration = startTime.msecsTo(m_data.back().dateTime);
-
-            int minLat = 900000000,  maxLat = -900000000;
-            int minLon = 1800000000, maxLon = -1800000000;
-
-            QVector< double > dt;
-            for (int i = 0; i < m_data.size(); ++i)
-            {
-                if (i > 0)
-                {
-                    dt.push_back(m_data[i - 1].dateTime.msecsTo(m_data[i].dateTime));
-                }
-
-                int lat = m_data[i].lat * 10000000;
-                int lon = m_data[i].lon * 10000000;
-
-                if (lat < minLat) minLat = lat;
-                if (lat > maxLat) maxLat = lat;
-                if (lon < minLon) minLon = lon;
-                if (lon > maxLon) maxLon = lon;
-            }
-            qSort(dt);
-            qint64 samplePeriod = dt[dt.size() / 2];
+            TrackImport::Summary summary;
+            TrackImport::summarize(mTrack.data(), summary);
 
             QDateTime importTime = QDateTime::currentDateTime();
 
@@ -781,13 +892,13 @@ void MainWindow::importFile(
                                     "max_lon=%7, "
                                     "import_time='%8' "
                                     "where file_name='%9'")
-                            .arg(dateTimeToUTC(startTime))
-                            .arg(duration)
-                            .arg(samplePeriod)
-                            .arg(minLat)
-                            .arg(maxLat)
-                            .arg(minLon)
-                            .arg(maxLon)
+                            .arg(dateTimeToUTC(summary.startTime))
+                            .arg(summary.duration)
+                            .arg(summary.samplePeriod)
+                            .arg(summary.minLat)
+                            .arg(summary.maxLat)
+                            .arg(summary.minLon)
+                            .arg(summary.maxLon)
                             .arg(dateTimeToUTC(importTime))
                             .arg(uniqueName)))
             {
@@ -797,14 +908,10 @@ void MainWindow::importFile(
         }
         else
         {
-            QMessageBox::critical(0, tr("Import failed"), tr("Couldn't copy temporary file"));
+            QMessageBox::critical(0, tr("Import failed"), tr("Couldn't write track file"));
         }
     }
 
-    // Delete temporary file
-    temporaryFile.close();
-    temporaryFile.remove();
-
     // Remember current track
     setTrackName(uniqueName);
 }
@@ -812,19 +919,17 @@ void MainWindow::importFile(
 void MainWindow::importFromDatabase(
         const QString &uniqueName)
 {
-    // Get name of file in database
-    QString newName = QString("FlySight/Tracks/%1.csv").arg(uniqueName);
-    QString newPath = QDir(mDatabasePath).filePath(newName);
-
-    QFile file(newPath);
-    if (!file.open(QIODevice::ReadOnly))
+    // Get measured data, reading the file if it isn't cached
+    TrackCache::Track track = mTrackCache.track(uniqueName);
+    if (track.isNull())
     {
         QMessageBox::critical(0, tr("Import failed"), tr("Couldn't read file"));
         return;
     }
 
-    // Read file data
-    import(&file, m_data, uniqueName, false);
+    // Derive remaining channels
+    mTrack.setData(track->toDataPoints());
+    initTrack(uniqueName, false);
 
     // Clear optimum
     m_optimal.clear();
@@ -888,30 +993,13 @@ void MainWindow::setTrackChecked(
 {
     if (checked)
     {
-        DataPoints data;
-
-        if (trackName == mTrackName)
+        // Track data is read from the cache when it's needed
+        if (trackName == mTrackName && !mTrackCache.contains(trackName))
         {
-            data = m_data;
+            mTrackCache.insert(trackName, TrackData(mTrack.data(), TrackData::Measured));
         }
-        else
-        {
-            // Get name of file in database
-            QString newName = QString("FlySight/Tracks/%1.csv").arg(trackName);
-            QString newPath = QDir(mDatabasePath).filePath(newName);
-
-            QFile file(newPath);
-            if (!file.open(QIODevice::ReadOnly))
-            {
-                QMessageBox::critical(0, tr("Import failed"), tr("Couldn't read file"));
-                return;
-            }
 
-            // Read file data
-            import(&file, data, trackName, false);
-        }
-
-        mCheckedTracks.insert(trackName, data);
+        mCheckedTracks.insert(trackName);
     }
     else
     {
@@ -930,184 +1018,82 @@ bool MainWindow::trackChecked(
 void MainWindow::importFromCheckedTrack(
         const QString &uniqueName)
 {
-    // Copy track data
-    m_data = mCheckedTracks[uniqueName];
-
-    // Clear optimum
-    m_optimal.clear();
-
-    // Initialize plot ranges
-    initRange(uniqueName);
-
-    emit dataLoaded();
-
-    // Remember current track
-    setTrackName(uniqueName);
+    // Checked tracks share the logbook cache
+    importFromDatabase(uniqueName);
 }
 
 void MainWindow::import(
-        QIODevice *device,
-        DataPoints &data,
+        const char *begin,
+        const char *end,
         QString trackName,
         bool initDatabase)
 {
-    QTextStream in(device);
-
-    // Column enumeration
-    typedef enum {
-        Time = 0,
-        Lat,
-        Lon,
-        HMSL,
-        VelN,
-        VelE,
-        VelD,
-        HAcc,
-        VAcc,
-        SAcc,
-        Heading,
-        CAcc,
-        NumSV
-    } Columns;
-
-    // Read column labels
-    QMap< int, int > colMap;
-    if (!in.atEnd())
-    {
-        QString line = in.readLine();
-        QStringList cols = line.split(",");
-
-        for (int i = 0; i < cols.size(); ++i)
-        {
-            const QString &s = cols[i];
-
-            if (s == "time")    colMap[Time]    = i;
-            if (s == "lat")     colMap[Lat]     = i;
-            if (s == "lon")     colMap[Lon]     = i;
-            if (s == "hMSL")    colMap[HMSL]    = i;
-            if (s == "velN")    colMap[VelN]    = i;
-            if (s == "velE")    colMap[VelE]    = i;
-            if (s == "velD")    colMap[VelD]    = i;
-            if (s == "hAcc")    colMap[HAcc]    = i;
-            if (s == "vAcc")    colMap[VAcc]    = i;
-            if (s == "sAcc")    colMap[SAcc]    = i;
-            if (s == "numSV")   colMap[NumSV]   = i;
-        }
-    }
+    // Parse track data
+    mTrack.parse(begin, end);
 
-    // Skip next row
-    if (!in.atEnd()) in.readLine();
-
-    data.clear();
-
-    while (!in.atEnd())
-    {
-        QString line = in.readLine();
-        QStringList cols = line.split(",");
-
-        DataPoint pt;
-
-        pt.dateTime = QDateTime::fromString(cols[colMap[Time]], Qt::ISODate);
-
-        pt.hasGeodetic = true;
-
-        pt.lat   = cols[colMap[Lat]].toDouble();
-        pt.lon   = cols[colMap[Lon]].toDouble();
-        pt.hMSL  = cols[colMap[HMSL]].toDouble();
-
-        pt.velN  = cols[colMap[VelN]].toDouble();
-        pt.velE  = cols[colMap[VelE]].toDouble();
-        pt.velD  = cols[colMap[VelD]].toDouble();
-
-        pt.hAcc  = cols[colMap[HAcc]].toDouble();
-        pt.vAcc  = cols[colMap[VAcc]].toDouble();
-        pt.sAcc  = cols[colMap[SAcc]].toDouble();
-
-        pt.numSV = cols[colMap[NumSV]].toDouble();
-
-        data.append(pt);
-    }
-
-    // Initialize time
-    initTime(data, trackName, initDatabase);
+    // Derive remaining channels
+    initTrack(trackName, initDatabase);
+}
 
-    // Altitude above ground
-    initAltitude(data, trackName, initDatabase);
+void MainWindow::initTrack(
+        QString trackName,
+        bool initDatabase)
+{
+    const Kinematics::Parameters params =
+            trackParameters(mTrack.data(), trackName, initDatabase);
 
-    // Wind adjustments
-    updateVelocity(data, trackName, initDatabase);
+    // Compute derived channels and remember parameters for incremental
+    // updates
+    mTrack.initialize(params);
 }
 
-void MainWindow::initTime(
-        DataPoints &data,
+Kinematics::Parameters MainWindow::trackParameters(
+        const DataPoints &data,
         QString trackName,
         bool initDatabase)
 {
+    Kinematics::Parameters params;
+
+    // Exit time
     QString value;
-    qint64 start;
     if (getDatabaseValue(trackName, "exit", value))
     {
-        start = QDateTime::fromString(value, Qt::ISODate)
+        params.exit = QDateTime::fromString(value, Qt::ISODate)
                 .toMSecsSinceEpoch();
     }
     else
     {
         const DataPoint &dp0 = data[data.size() - 1];
-        start = dp0.dateTime.toMSecsSinceEpoch();
+        params.exit = dp0.dateTime.toMSecsSinceEpoch();
     }
 
     if (initDatabase)
     {
-        QDateTime dt = QDateTime::fromMSecsSinceEpoch(start, Qt::UTC);
+        QDateTime dt = QDateTime::fromMSecsSinceEpoch(params.exit, Qt::UTC);
         setDatabaseValue(trackName, "exit", dateTimeToUTC(dt));
     }
 
-    for (int i = 0; i < data.size(); ++i)
-    {
-        DataPoint &dp = data[i];
-        qint64 end = dp.dateTime.toMSecsSinceEpoch();
-        dp.t = (double) (end - start) / 1000;
-    }
-}
-
-void MainWindow::initAltitude(
-        DataPoints &data,
-        QString trackName,
-        bool initDatabase)
-{
-    QString value;
-    double ground;
+    // Ground elevation
     if (getDatabaseValue(trackName, "ground", value))
     {
-        ground = value.toDouble();
+        params.ground = value.toDouble();
     }
     else if (mGroundReference == Automatic)
     {
         const DataPoint &dp0 = data[data.size() - 1];
-        ground = dp0.hMSL;
+        params.ground = dp0.hMSL;
     }
     else
     {
-        ground = mFixedReference;
+        params.ground = mFixedReference;
     }
 
     if (initDatabase)
     {
-        setDatabaseValue(trackName, "ground", QString::number(ground, 'f', 3));
+        setDatabaseValue(trackName, "ground", QString::number(params.ground, 'f', 3));
     }
 
-    for (int i = 0; i < data.size(); ++i)
-    {
-        DataPoint &dp = data[i];
-        dp.z = dp.hMSL - ground;
-    }
-}
-
-void MainWindow::updateVelocity(
-        DataPoints &data,
-        QString trackName,
-        bool initDatabase)
-{
+    // Wind adjustments
     double windE, windN;
     getWind(trackName, &windE, &windN);
 
@@ -1117,233 +1103,48 @@ void MainWindow::updateVelocity(
         setDatabaseValue(trackName, "wind_n", QString::number(windN, 'f', 2));
     }
 
-    if (mWindAdjustment)
-    {
-        // Wind-adjusted position
-        for (int i = 0; i < data.size(); ++i)
-        {
-            const DataPoint &dp0 = interpolateDataT(0);
-            DataPoint &dp = data[i];
-
-            double distance = getDistance(dp0, dp);
-            double bearing = getBearing(dp0, dp);
-
-            dp.x = distance * sin(bearing) - windE * dp.t;
-            dp.y = distance * cos(bearing) - windN * dp.t;
-        }
-
-        // Wind-adjusted velocity
-        for (int i = 0; i < data.size(); ++i)
-        {
-            DataPoint &dp = data[i];
-
-            dp.vx = dp.velE - windE;
-            dp.vy = dp.velN - windN;
-        }
-    }
-    else
-    {
-        // Unadjusted position
-        for (int i = 0; i < data.size(); ++i)
-        {
-            const DataPoint &dp0 = interpolateDataT(0);
-            DataPoint &dp = data[i];
-
-            double distance = getDistance(dp0, dp);
-            double bearing = getBearing(dp0, dp);
-
-            dp.x = distance * sin(bearing);
-            dp.y = distance * cos(bearing);
-        }
-
-        // Unadjusted velocity
-        for (int i = 0; i < data.size(); ++i)
-        {
-            DataPoint &dp = data[i];
-
-            dp.vx = dp.velE;
-            dp.vy = dp.velN;
-        }
-    }
-
-    // Distance measurements
-    double dist2D = 0, dist3D = 0;
-
-    for (int i = 0; i < data.size(); ++i)
-    {
-        DataPoint &dp = data[i];
-
-        if (i > 0)
-        {
-            const DataPoint &dpPrev = data[i - 1];
-
-            double dx = dp.x - dpPrev.x;
-            double dy = dp.y - dpPrev.y;
-            double dh = sqrt(dx * dx + dy * dy);
-            double dz = dp.hMSL - dpPrev.hMSL;
-
-            dist2D += dh;
-            dist3D += sqrt(dh * dh + dz * dz);
-        }
-
-        dp.dist2D = dist2D;
-        dp.dist3D = dist3D;
-    }
+    params.windE = mWindAdjustment ? windE : 0;
+    params.windN = mWindAdjustment ? windN : 0;
 
-    QString value;
-    double theta0;
+    // Reference heading
     if (getDatabaseValue(trackName, "course", value))
     {
-        theta0 = value.toDouble();
+        params.course = value.toDouble();
     }
     else
     {
-        theta0 = 0;
+        params.course = 0;
     }
 
     if (initDatabase)
     {
-        setDatabaseValue(trackName, "course", QString::number(theta0, 'f', 5));
+        setDatabaseValue(trackName, "course", QString::number(params.course, 'f', 5));
     }
 
-    // Cumulative heading
-    double prevHeading;
-    bool firstHeading = true;
-
-    for (int i = 0; i < data.size(); ++i)
-    {
-        DataPoint &dp = data[i];
-
-        // Calculate heading
-        dp.heading = atan2(dp.vx, dp.vy) / PI * 180;
-
-        // Calculate heading accuracy
-        const double s = DataPoint::totalSpeed(dp);
-        if (s != 0) dp.cAcc = dp.sAcc / s;
-        else        dp.cAcc = 0;
-
-        // Adjust heading
-        if (!firstHeading)
-        {
-            while (dp.heading <  prevHeading - 180) dp.heading += 360;
-            while (dp.heading >= prevHeading + 180) dp.heading -= 360;
-        }
-
-        // Relative heading
-        dp.theta = dp.heading - theta0;
-
-        firstHeading = false;
-        prevHeading = dp.heading;
-    }
-
-    // Parameters depending on velocity
-    for (int i = 0; i < data.size(); ++i)
-    {
-        DataPoint &dp = data[i];
-
-        dp.curv = getSlope(i, DataPoint::diveAngle);
-        dp.accel = getSlope(i, DataPoint::totalSpeed);
-        dp.omega = getSlope(i, DataPoint::course);
-    }
-
-    // Initialize aerodynamics
-    initAerodynamics(data);
-}
-
-void MainWindow::initAerodynamics(
-        DataPoints &data)
-{
-    for (int i = 0; i < data.size(); ++i)
-    {
-        DataPoint &dp = data[i];
-
-        // Acceleration
-        double accelN = getSlope(i, DataPoint::northSpeed);
-        double accelE = getSlope(i, DataPoint::eastSpeed);
-        double accelD = getSlope(i, DataPoint::verticalSpeed);
-
-        // Subtract acceleration due to gravity
-        accelD -= A_GRAVITY;
-
-        // Calculate acceleration due to drag
-        const double vel = DataPoint::totalSpeed(dp);
-        const double proj = (accelN * dp.vy + accelE * dp.vx + accelD * dp.velD) / vel;
-
-        const double dragN = proj * dp.vy / vel;
-        const double dragE = proj * dp.vx / vel;
-        const double dragD = proj * dp.velD / vel;
-
-        const double accelDrag = sqrt(dragN * dragN + dragE * dragE + dragD * dragD);
-
-        // Calculate acceleration due to lift
-        const double liftN = accelN - dragN;
-        const double liftE = accelE - dragE;
-        const double liftD = accelD - dragD;
-
-        const double accelLift = sqrt(liftN * liftN + liftE * liftE + liftD * liftD);
-
-        // From https://en.wikipedia.org/wiki/Atmospheric_pressure#Altitude_variation
-        const double airPressure = SL_PRESSURE * pow(1 - LAPSE_RATE * dp.hMSL / SL_TEMP, A_GRAVITY * MM_AIR / GAS_CONST / LAPSE_RATE);
-
-        // From https://en.wikipedia.org/wiki/Lapse_rate
-        const double temperature = SL_TEMP - LAPSE_RATE * dp.hMSL;
+    // Aerodynamics
+    params.mass = m_mass;
+    params.planformArea = m_planformArea;
+    params.halfWidth = m_slopeWindow / 2;
 
-        // From https://en.wikipedia.org/wiki/Density_of_air
-        const double airDensity = airPressure / (GAS_CONST / MM_AIR) / temperature;
-
-        // From https://en.wikipedia.org/wiki/Dynamic_pressure
-        const double dynamicPressure = airDensity * vel * vel / 2;
-
-        // Calculate lift and drag coefficients
-        dp.lift = m_mass * accelLift / dynamicPressure / m_planformArea;
-        dp.drag = m_mass * accelDrag / dynamicPressure / m_planformArea;
-    }
+    return params;
 }
 
-double MainWindow::getSlope(
-        const int center,
-        double (*value)(const DataPoint &)) const
+void MainWindow::updateTrack()
 {
-    int iMin = qMax (0, center - 2);
-    int iMax = qMin (m_data.size () - 1, center + 2);
-
-    double sumx = 0, sumy = 0, sumxx = 0, sumxy = 0;
-
-    for (int i = iMin; i <= iMax; ++i)
-    {
-        const DataPoint &dp = m_data[i];
-        double y = value(dp);
+    if (mTrack.isEmpty()) return;
 
-        sumx += dp.t;
-        sumy += y;
-        sumxx += dp.t * dp.t;
-        sumxy += dp.t * y;
-    }
+    const Kinematics::Parameters params =
+            trackParameters(mTrack.data(), mTrackName, false);
 
-    int n = iMax - iMin + 1;
-    return (sumxy - sumx * sumy / n) / (sumxx - sumx * sumx / n);
+    // Recompute only the channels which depend on changed parameters
+    mTrack.update(params);
 }
 
 double MainWindow::getDistance(
         const DataPoint &dp1,
         const DataPoint &dp2)
 {
-    if (dp1.hasGeodetic && dp2.hasGeodetic)
-    {
-        const Geodesic &geod = Geodesic::WGS84();
-        double s12;
-
-        geod.Inverse(dp1.lat, dp1.lon, dp2.lat, dp2.lon, s12);
-
-        return s12;
-    }
-    else
-    {
-        const double dx = dp2.x - dp1.x;
-        const double dy = dp2.y - dp1.y;
-
-        return sqrt(dx * dx + dy * dy);
-    }
+    return ScoringRules::distance(dp1, dp2);
 }
 
 double MainWindow::getBearing(
@@ -1362,12 +1163,12 @@ void MainWindow::setMark(
         double start,
         double end)
 {
-    if (m_data.isEmpty()) return;
+    if (mTrack.isEmpty()) return;
 
-    if (start >= m_data.front().t &&
-            start <= m_data.back().t &&
-            end >= m_data.front().t &&
-            end <= m_data.back().t)
+    if (start >= mTrack.first().t &&
+            start <= mTrack.last().t &&
+            end >= mTrack.first().t &&
+            end <= mTrack.last().t)
     {
         mMarkStart = start;
         mMarkEnd = end;
@@ -1384,10 +1185,10 @@ void MainWindow::setMark(
 void MainWindow::setMark(
         double mark)
 {
-    if (m_data.isEmpty()) return;
+    if (mTrack.isEmpty()) return;
 
-    if (mark >= m_data.front().t &&
-            mark <= m_data.back().t)
+    if (mark >= mTrack.first().t &&
+            mark <= mTrack.last().t)
     {
         mMarkStart = mMarkEnd = mark;
         mMarkActive = true;
@@ -1418,18 +1219,18 @@ void MainWindow::initRange(
     if (getDatabaseValue(trackName, "t_min", strMin)
             && getDatabaseValue(trackName, "t_max", strMax))
     {
-        const DataPoint &dp0 = m_data[0];
+        const DataPoint &dp0 = mTrack[0];
         mZoomLevel.rangeLower = dp0.t + dp0.dateTime.msecsTo(
                     QDateTime::fromString(strMin, Qt::ISODate)) / 1000.;
         mZoomLevel.rangeUpper = dp0.t + dp0.dateTime.msecsTo(
                     QDateTime::fromString(strMax, Qt::ISODate)) / 1000.;
     }
-    else if (!m_data.isEmpty())
+    else if (!mTrack.isEmpty())
     {
         double lower, upper;
-        for (int i = 0; i < m_data.size(); ++i)
+        for (int i = 0; i < mTrack.size(); ++i)
         {
-            const DataPoint &dp = m_data[i];
+            const DataPoint &dp = mTrack[i];
 
             if (i == 0)
             {
@@ -1457,7 +1258,7 @@ void MainWindow::initRange(
     m_ui->actionRedoZoom->setEnabled(false);
 
     // Enable zoom to extent
-    m_ui->actionZoomToExtent->setEnabled(!m_data.isEmpty());
+    m_ui->actionZoomToExtent->setEnabled(!mTrack.isEmpty());
 }
 
 void MainWindow::on_actionElevation_triggered()
@@ -1639,16 +1440,7 @@ void MainWindow::on_actionWind_triggered()
     m_ui->actionWind->setChecked(mWindAdjustment);
 
     // Update plot data
-    updateVelocity(m_data, mTrackName, false);
-
-    // Update checked tracks
-    QMap< QString, DataPoints >::iterator p;
-    for (p = mCheckedTracks.begin();
-         p != mCheckedTracks.end();
-         ++p)
-    {
-        updateVelocity(p.value(), p.key(), false);
-    }
+    updateTrack();
 
     emit dataChanged();
 }
@@ -1712,11 +1504,14 @@ void MainWindow::on_actionPreferences_triggered()
     dlg.setUnits(m_units);
     dlg.setMass(m_mass);
     dlg.setPlanformArea(m_planformArea);
+    dlg.setSlopeWindow(m_slopeWindow);
     dlg.setMinDrag(m_minDrag);
     dlg.setMinLift(m_minLift);
     dlg.setMaxLift(m_maxLift);
     dlg.setMaxLD(m_maxLD);
     dlg.setSimulationTime(m_simulationTime);
+    dlg.setBatchSimulation(m_batchSimulation);
+    dlg.setOptimizationAlgorithm(m_optimizationAlgorithm);
     dlg.setLineThickness(mLineThickness);
 
     const double factor = (m_units == PlotValue::Metric) ? MPS_TO_KMH : MPS_TO_MPH;
@@ -1735,6 +1530,7 @@ void MainWindow::on_actionPreferences_triggered()
     dlg.setFixedReference(mFixedReference);
 
     dlg.setDatabasePath(mDatabasePath);
+    dlg.setTrackCacheSize(mTrackCacheSize);
 
     if (dlg.exec() == QDialog::Accepted)
     {
@@ -1752,13 +1548,17 @@ void MainWindow::on_actionPreferences_triggered()
             m_planformArea = dlg.planformArea();
 
             // Update plot data
-            initAerodynamics(m_data);
+            updateTrack();
 
-            // Update checked tracks
-            foreach (DataPoints data, mCheckedTracks)
-            {
-                initAerodynamics(data);
-            }
+            emit dataChanged();
+        }
+
+        if (m_slopeWindow != dlg.slopeWindow())
+        {
+            m_slopeWindow = dlg.slopeWindow();
+
+            // Update plot data
+            updateTrack();
 
             emit dataChanged();
         }
@@ -1777,6 +1577,8 @@ void MainWindow::on_actionPreferences_triggered()
         }
 
         m_simulationTime = dlg.simulationTime();
+        m_batchSimulation = dlg.batchSimulation();
+        m_optimizationAlgorithm = dlg.optimizationAlgorithm();
 
         bool plotChanged = false;
         for (int i = 0; i < plotArea()->yaLast; ++i)
@@ -1841,6 +1643,12 @@ void MainWindow::on_actionPreferences_triggered()
             mFixedReference = dlg.fixedReference();
         }
 
+        if (mTrackCacheSize != dlg.trackCacheSize())
+        {
+            mTrackCacheSize = dlg.trackCacheSize();
+            mTrackCache.setBudget((qint64) mTrackCacheSize * 1024 * 1024);
+        }
+
         if (mDatabasePath != dlg.databasePath())
         {
             // Change the database path
@@ -2158,23 +1966,12 @@ void MainWindow::setRotation(
 void MainWindow::setZero(
         double t)
 {
-    if (m_data.isEmpty()) return;
+    if (mTrack.isEmpty()) return;
 
-    DataPoint dp0 = interpolateDataT(t);
+    // Channels are shifted rather than recomputed
+    DataPoint dp0 = mTrack.setExit(t);
     setDatabaseValue(mTrackName, "exit", dateTimeToUTC(dp0.dateTime));
 
-    for (int i = 0; i < m_data.size(); ++i)
-    {
-        DataPoint &dp = m_data[i];
-
-        dp.t -= dp0.t;
-        dp.x -= dp0.x;
-        dp.y -= dp0.y;
-
-        dp.dist2D -= dp0.dist2D;
-        dp.dist3D -= dp0.dist3D;
-    }
-
     mMarkStart -= dp0.t;
     mMarkEnd -= dp0.t;
 
@@ -2201,7 +1998,7 @@ void MainWindow::setZero(
 void MainWindow::setGround(
         double t)
 {
-    if (m_data.isEmpty()) return;
+    if (mTrack.isEmpty()) return;
 
     DataPoint dp0 = interpolateDataT(t);
     setTrackGround(mTrackName, dp0.hMSL);
@@ -2218,21 +2015,9 @@ void MainWindow::setTrackGround(
     // Update current track
     if (trackName == mTrackName)
     {
-        updateGround(m_data, ground);
+        updateTrack();
         emit dataChanged();
     }
-
-    // Update checked tracks
-    QMap< QString, DataPoints >::iterator p;
-    for (p = mCheckedTracks.begin();
-         p != mCheckedTracks.end();
-         ++p)
-    {
-        if (trackName == p.key())
-        {
-            updateGround(p.value(), ground);
-        }
-    }
 }
 
 void MainWindow::setTrackWindSpeed(
@@ -2252,21 +2037,9 @@ void MainWindow::setTrackWindSpeed(
     // Update current track
     if (trackName == mTrackName)
     {
-        updateVelocity(m_data, mTrackName, false);
+        updateTrack();
         emit dataChanged();
     }
-
-    // Update checked tracks
-    QMap< QString, DataPoints >::iterator p;
-    for (p = mCheckedTracks.begin();
-         p != mCheckedTracks.end();
-         ++p)
-    {
-        if (trackName == p.key())
-        {
-            updateVelocity(p.value(), p.key(), false);
-        }
-    }
 }
 
 void MainWindow::setTrackWindDir(
@@ -2286,47 +2059,21 @@ void MainWindow::setTrackWindDir(
     // Update current track
     if (trackName == mTrackName)
     {
-        updateVelocity(m_data, mTrackName, false);
+        updateTrack();
         emit dataChanged();
     }
-
-    // Update checked tracks
-    QMap< QString, DataPoints >::iterator p;
-    for (p = mCheckedTracks.begin();
-         p != mCheckedTracks.end();
-         ++p)
-    {
-        if (trackName == p.key())
-        {
-            updateVelocity(p.value(), p.key(), false);
-        }
-    }
-}
-
-void MainWindow::updateGround(
-        DataPoints &data,
-        double ground)
-{
-    for (int i = 0; i < data.size(); ++i)
-    {
-        DataPoint &dp = data[i];
-        dp.z = dp.hMSL - ground;
-    }
 }
 
 void MainWindow::setCourse(
         double t)
 {
-    if (m_data.isEmpty()) return;
+    if (mTrack.isEmpty()) return;
 
     DataPoint dp0 = interpolateDataT(t);
     setDatabaseValue(mTrackName, "course", QString::number(dp0.heading, 'f', 5));
 
-    for (int i = 0; i < m_data.size(); ++i)
-    {
-        DataPoint &dp = m_data[i];
-        dp.theta -= dp0.theta;
-    }
+    // Update plot data
+    updateTrack();
 
     emit dataChanged();
 
@@ -2338,6 +2085,8 @@ bool MainWindow::setDatabaseValue(
         QString column,
         QString value)
 {
+    ProfileScope scope("MainWindow::setDatabaseValue");
+
     QSqlQuery query(mDatabase);
 
     // Check the old value
@@ -2370,6 +2119,8 @@ bool MainWindow::getDatabaseValue(
         QString column,
         QString &value)
 {
+    ProfileScope scope("MainWindow::getDatabaseValue");
+
     QSqlQuery query(mDatabase);
 
     // Read value from database
@@ -2467,16 +2218,7 @@ void MainWindow::setWind(
     setDatabaseValue(mTrackName, "wind_n", QString::number(windN, 'f', 2));
 
     // Update plot data
-    updateVelocity(m_data, mTrackName, false);
-
-    // Update checked tracks
-    QMap< QString, DataPoints >::iterator p;
-    for (p = mCheckedTracks.begin();
-         p != mCheckedTracks.end();
-         ++p)
-    {
-        updateVelocity(p.value(), p.key(), false);
-    }
+    updateTrack();
 
     emit dataChanged();
 }
@@ -2556,9 +2298,9 @@ void MainWindow::saveZoomToDatabase()
 void MainWindow::on_actionZoomToExtent_triggered()
 {
     double lower, upper;
-    for (int i = 0; i < m_data.size(); ++i)
+    for (int i = 0; i < mTrack.size(); ++i)
     {
-        const DataPoint &dp = m_data[i];
+        const DataPoint &dp = mTrack[i];
 
         if (i == 0)
         {
@@ -2584,7 +2326,7 @@ void MainWindow::on_actionDeleteTrack_triggered()
         if (uniqueName == mTrackName)
         {
             // Clear track data
-            m_data.clear();
+            mTrack.clear();
             emit dataChanged();
 
             // Clear current track name;
@@ -2595,12 +2337,17 @@ void MainWindow::on_actionDeleteTrack_triggered()
         QString newName = QString("FlySight/Tracks/%1.csv").arg(uniqueName);
         QString newPath = QDir(mDatabasePath).filePath(newName);
 
-        // Delete the track
+        // Delete the track. The source goes first so that a sidecar still
+        // being written in the background is not left behind.
+        mTrackCache.remove(uniqueName);
+
         if (!QFile::remove(newPath))
         {
             QMessageBox::critical(0, tr("Operation failed"), tr("Couldn't delete track"));
         }
 
+        TrackStore::remove(mDatabasePath, uniqueName);
+
         // Remove track from database
         QSqlQuery query(mDatabase);
         if (!query.exec(QString("delete from files where file_name='%1'").arg(uniqueName)))
@@ -2638,26 +2385,14 @@ void MainWindow::setScoringMode(
 void MainWindow::prepareDataPlot(
         DataPlot *plot)
 {
-    plot->setCurrentLayer("background");
-
-    foreach (QCPLayerable *l, plot->currentLayer()->children())
-    {
-        if (qobject_cast<QCPAbstractPlottable*>(l))
-        {
-            plot->removePlottable((QCPAbstractPlottable*) l);
-        }
-        else if (qobject_cast<QCPAbstractItem*>(l))
-        {
-            plot->removeItem((QCPAbstractItem*) l);
-        }
-    }
+    plot->beginAnnotations();
 
     if (mScoringView->isVisible())
     {
         mScoringMethods[mScoringMode]->prepareDataPlot(plot);
     }
 
-    plot->setCurrentLayer("main");
+    plot->endAnnotations();
 }
 
 void MainWindow::prepareMapView(
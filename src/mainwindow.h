@@ -27,6 +27,7 @@
 #include <QLabel>
 #include <QMainWindow>
 #include <QMap>
+#include <QSet>
 #include <QSqlDatabase>
 #include <QStack>
 #include <QVector>
@@ -34,10 +35,14 @@
 #include "dataplot.h"
 #include "datapoint.h"
 #include "dataview.h"
+#include "kinematics.h"
+#include "track.h"
+#include "trackcache.h"
 
 class MapView;
 class QCPRange;
 class QCustomPlot;
+class RefreshScheduler;
 class ScoringMethod;
 class ScoringView;
 
@@ -70,14 +75,21 @@ public:
         Automatic, Fixed
     } GroundReference;
 
+    typedef enum {
+        Genetic, CMAES, Gradient
+    } OptimizationAlgorithm;
+
     typedef QVector< DataPoint > DataPoints;
 
     explicit MainWindow(QWidget *parent = 0);
     ~MainWindow();
 
-    const DataPoints &data() const { return m_data; }
-    int dataSize() const { return m_data.size(); }
-    const DataPoint &dataPoint(int i) const { return m_data[i]; }
+    // Current track; the data accessors below forward to it
+    const Track &track() const { return mTrack; }
+
+    const DataPoints &data() const { return mTrack.data(); }
+    int dataSize() const { return mTrack.size(); }
+    const DataPoint &dataPoint(int i) const { return mTrack[i]; }
 
     PlotValue::Units units() const { return m_units; }
 
@@ -124,6 +136,7 @@ public:
 
     double mass() const { return m_mass; }
     double planformArea() const { return m_planformArea; }
+    int slopeWindow() const { return m_slopeWindow; }
 
     double minDrag() const { return m_minDrag; }
     double minLift() const { return m_minLift; }
@@ -131,6 +144,8 @@ public:
     double maxLD() const { return m_maxLD; }
 
     int simulationTime() const { return m_simulationTime; }
+    bool batchSimulation() const { return m_batchSimulation; }
+    OptimizationAlgorithm optimizationAlgorithm() const { return m_optimizationAlgorithm; }
 
     void setMinDrag(double minDrag);
     void setMaxLift(double maxLift);
@@ -154,6 +169,8 @@ public:
 
     double getQNE(void) const { return mFixedReference;}
 
+    const TrackCache &trackCache() const { return mTrackCache; }
+
     void setScoringMode(ScoringMode mode);
     ScoringMode scoringMode() const { return mScoringMode; }
     ScoringMethod *scoringMethod(int i) const { return mScoringMethods[i]; }
@@ -240,7 +257,7 @@ private:
     } ZoomLevel;
 
     Ui::MainWindow       *m_ui;
-    DataPoints            m_data;
+    Track                 mTrack;
     DataPoints            m_optimal;
 
     double                mMarkStart;
@@ -273,6 +290,7 @@ private:
 
     double                m_mass;
     double                m_planformArea;
+    int                   m_slopeWindow;
 
     double                m_minDrag;
     double                m_minLift;
@@ -280,6 +298,8 @@ private:
     double                m_maxLD;
 
     int                   m_simulationTime;
+    bool                  m_batchSimulation;
+    OptimizationAlgorithm m_optimizationAlgorithm;
 
     double                mLineThickness;
 
@@ -289,15 +309,20 @@ private:
     GroundReference       mGroundReference;
     double                mFixedReference;
 
+    TrackCache            mTrackCache;
+    int                   mTrackCacheSize;
+
     QString               mDatabasePath;
     QSqlDatabase          mDatabase;
 
     QString               mTrackName;
     QVector< QString >    mSelectedTracks;
-    QMap< QString, DataPoints > mCheckedTracks;
+    QSet< QString >       mCheckedTracks;
 
     QTimer               *zoomTimer;
 
+    RefreshScheduler     *mRefreshScheduler;
+
     void writeSettings();
     void readSettings();
 
@@ -315,24 +340,24 @@ private:
     void initOrthoView();
     void initPlaybackView();
     void initLogbookView();
+    void initPerformanceView();
 
     void initSingleView(const QString &title, const QString &objectName,
                         QAction *actionShow, DataView::Direction direction);
 
-    void import(QIODevice *device, DataPoints &data, QString trackName, bool initDatabase);
-    void initTime(DataPoints &data, QString trackName, bool initDatabase);
-    void initAltitude(DataPoints &data, QString trackName, bool initDatabase);
-    void updateVelocity(DataPoints &data, QString trackName, bool initDatabase);
-    void initAerodynamics(DataPoints &data);
+    void findFiles(QString folderName, QStringList &fileNames);
+
+    void import(const char *begin, const char *end, QString trackName, bool initDatabase);
+    void initTrack(QString trackName, bool initDatabase);
+    Kinematics::Parameters trackParameters(const DataPoints &data, QString trackName, bool initDatabase);
+    void updateTrack();
 
-    double getSlope(const int center, double (*value)(const DataPoint &)) const;
 
     void initRange(QString trackName);
 
     void updateBottomActions();
     void updateLeftActions();
 
-    void updateGround(DataPoints &data, double ground);
     QString dateTimeToUTC(const QDateTime &dt);
 
 signals:
@@ -347,6 +372,7 @@ signals:
 public slots:
     void importFolder(QString folderName);
     void importFile(QString fileName);
+    void importFiles(QStringList fileNames);
 
 private slots:
     void setScoringVisible(bool visible);
@@ -0,0 +1,65 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "mappath.h"
+
+QVector< int > MapPath::decimate(
+        const QVector< DataPoint > &data,
+        double lower,
+        double upper,
+        double threshold)
+{
+    QVector< int > indices;
+
+    double distPrev;
+    for (int i = 0; i < data.size(); ++i)
+    {
+        const DataPoint &dp = data[i];
+
+        if (i > 0 && dp.dist2D - distPrev < threshold) continue;
+        distPrev = dp.dist2D;
+
+        if (lower <= dp.t && dp.t <= upper)
+        {
+            indices.append(i);
+        }
+    }
+
+    return indices;
+}
+
+QString MapPath::script(
+        const QVector< DataPoint > &data,
+        const QVector< int > &indices)
+{
+    QString js = QString("var path = poly.getPath();") +
+                 QString("while (path.length > 0) { path.pop(); }");
+
+    foreach (int i, indices)
+    {
+        const DataPoint &dp = data[i];
+        js += QString("path.push(new google.maps.LatLng(%1, %2));").arg(dp.lat, 0, 'f').arg(dp.lon, 0, 'f');
+    }
+
+    return js;
+}
@@ -0,0 +1,47 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef MAPPATH_H
+#define MAPPATH_H
+
+#include <QString>
+#include <QVector>
+
+#include "datapoint.h"
+
+// Track polyline shown on the map, thinned to what is visible at the
+// current zoom level
+
+namespace MapPath
+{
+    // Samples within [lower, upper], skipping any which are closer than
+    // threshold along the ground to the previous sample kept
+    QVector< int > decimate(const QVector< DataPoint > &data,
+                            double lower, double upper, double threshold);
+
+    // JavaScript which replaces the points of the map's track polyline
+    QString script(const QVector< DataPoint > &data,
+                   const QVector< int > &indices);
+}
+
+#endif // MAPPATH_H
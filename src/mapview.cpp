@@ -29,6 +29,8 @@
 
 #include "common.h"
 #include "mainwindow.h"
+#include "mappath.h"
+#include "profiler.h"
 
 MapView::MapView(QWidget *parent) :
     QWebView(parent),
@@ -168,6 +170,8 @@ bool MapView::updateReference(
 
 void MapView::initView()
 {
+    ProfileScope scope("MapView::initView");
+
     double xMin, xMax;
     double yMin, yMax;
 
@@ -201,51 +205,21 @@ void MapView::initView()
 
 void MapView::updateView()
 {
+    ProfileScope scope("MapView::updateView");
+
     double lower = mMainWindow->rangeLower();
     double upper = mMainWindow->rangeUpper();
 
-    double xMin, xMax;
-    double yMin, yMax;
-
-    bool first = true;
-
     // Distance threshold
     const double earthCircumference = 40075000; // m
     const double zoom = page()->currentFrame()->documentElement().evaluateJavaScript("map.getZoom();").toDouble();
     const double threshold = earthCircumference / pow(2, zoom) / width();
 
     // Add track to map
-    QString js = QString("var path = poly.getPath();") +
-                 QString("while (path.length > 0) { path.pop(); }");
-
-    double distPrev;
-    for (int i = 0; i < mMainWindow->dataSize(); ++i)
-    {
-        const DataPoint &dp = mMainWindow->dataPoint(i);
+    const QVector< int > indices = MapPath::decimate(mMainWindow->data(), lower, upper, threshold);
+    QString js = MapPath::script(mMainWindow->data(), indices);
 
-        if (i > 0 && dp.dist2D - distPrev < threshold) continue;
-        distPrev = dp.dist2D;
-
-        if (lower <= dp.t && dp.t <= upper)
-        {
-            if (first)
-            {
-                xMin = xMax = dp.lon;
-                yMin = yMax = dp.lat;
-                first = false;
-            }
-            else
-            {
-                if (dp.lon < xMin) xMin = dp.lon;
-                if (dp.lon > xMax) xMax = dp.lon;
-
-                if (dp.lat < yMin) yMin = dp.lat;
-                if (dp.lat > yMax) yMax = dp.lat;
-            }
-
-            js += QString("path.push(new google.maps.LatLng(%1, %2));").arg(dp.lat, 0, 'f').arg(dp.lon, 0, 'f');
-        }
-    }
+    Profiler::instance()->addCount("MapView path points", indices.size());
 
     page()->currentFrame()->documentElement().evaluateJavaScript(js);
 
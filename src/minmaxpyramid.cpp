@@ -0,0 +1,217 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "minmaxpyramid.h"
+
+#include <QtNumeric>
+
+#include <algorithm>
+
+#include "profiler.h"
+
+MinMaxPyramid::MinMaxPyramid()
+{
+
+}
+
+MinMaxPyramid::MinMaxPyramid(
+        const QVector< double > &x,
+        const QVector< double > &y):
+    mX(x),
+    mY(y)
+{
+    ProfileScope scope("MinMaxPyramid::build");
+
+    // Level 1 from pairs of samples
+    QVector< Bucket > level((mX.size() + 1) / 2);
+    for (int j = 0; j < level.size(); ++j)
+    {
+        const int i1 = 2 * j;
+        const int i2 = qMin(i1 + 1, mX.size() - 1);
+
+        level[j].lower = below(i1, i2);
+        level[j].upper = above(i1, i2);
+    }
+
+    // Each further level from pairs of buckets in the one before
+    while (level.size() > 1)
+    {
+        mLevels.append(level);
+
+        const QVector< Bucket > &prev = mLevels.last();
+        level = QVector< Bucket >((prev.size() + 1) / 2);
+        for (int j = 0; j < level.size(); ++j)
+        {
+            const Bucket &b1 = prev[2 * j];
+            const Bucket &b2 = prev[qMin(2 * j + 1, prev.size() - 1)];
+
+            level[j].lower = below(b1.lower, b2.lower);
+            level[j].upper = above(b1.upper, b2.upper);
+        }
+    }
+
+    if (!level.isEmpty())
+    {
+        mLevels.append(level);
+    }
+}
+
+int MinMaxPyramid::below(
+        int i1,
+        int i2) const
+{
+    // Prefer a real value over NaN, which marks a gap
+    return (mY[i2] < mY[i1] || qIsNaN(mY[i1])) ? i2 : i1;
+}
+
+int MinMaxPyramid::above(
+        int i1,
+        int i2) const
+{
+    return (mY[i2] > mY[i1] || qIsNaN(mY[i1])) ? i2 : i1;
+}
+
+MinMaxPyramid::Bucket MinMaxPyramid::bucket(
+        int level,
+        int j) const
+{
+    if (level > 0) return mLevels[level - 1][j];
+
+    Bucket b;
+    b.lower = b.upper = j;
+    return b;
+}
+
+void MinMaxPyramid::sample(
+        double lower,
+        double upper,
+        int pixels,
+        QVector< double > &x,
+        QVector< double > &y) const
+{
+    x.clear();
+    y.clear();
+
+    if (mX.isEmpty()) return;
+
+    // Visible samples plus one on either side
+    int i1 = std::lower_bound(mX.begin(), mX.end(), lower) - mX.begin();
+    int i2 = std::upper_bound(mX.begin(), mX.end(), upper) - mX.begin();
+
+    i1 = qMax(i1 - 1, 0);
+    i2 = qMin(i2, mX.size() - 1);
+    if (i2 < i1) return;
+
+    // Coarsest level whose buckets are at most half a pixel wide
+    const int count = i2 - i1 + 1;
+    int k = 0;
+    while (k < mLevels.size() && (2 << k) * 2 * qMax(pixels, 1) <= count)
+    {
+        ++k;
+    }
+
+    if (k == 0)
+    {
+        x.reserve(count);
+        y.reserve(count);
+        for (int i = i1; i <= i2; ++i)
+        {
+            x.append(mX[i]);
+            y.append(mY[i]);
+        }
+        return;
+    }
+
+    const QVector< Bucket > &level = mLevels[k - 1];
+    const int j1 = i1 >> k;
+    const int j2 = i2 >> k;
+
+    x.reserve(2 * (j2 - j1 + 1));
+    y.reserve(2 * (j2 - j1 + 1));
+    for (int j = j1; j <= j2; ++j)
+    {
+        const Bucket &b = level[j];
+        const int first = qMin(b.lower, b.upper);
+        const int second = qMax(b.lower, b.upper);
+
+        x.append(mX[first]);
+        y.append(mY[first]);
+
+        if (second != first)
+        {
+            x.append(mX[second]);
+            y.append(mY[second]);
+        }
+    }
+}
+
+bool MinMaxPyramid::extrema(
+        double lower,
+        double upper,
+        double &min,
+        double &max) const
+{
+    const int first = std::lower_bound(mX.begin(), mX.end(), lower) - mX.begin();
+    const int last = std::upper_bound(mX.begin(), mX.end(), upper) - mX.begin() - 1;
+
+    return sampleExtrema(first, last, min, max);
+}
+
+bool MinMaxPyramid::sampleExtrema(
+        int first,
+        int last,
+        double &min,
+        double &max) const
+{
+    int i1 = qMax(first, 0);
+    int i2 = qMin(last, mX.size() - 1);
+
+    if (i2 < i1) return false;
+
+    // Climb the levels, taking the buckets at either end which are not
+    // wholly covered by a bucket on the next level
+    int iLower = i1, iUpper = i1;
+    for (int k = 0; i1 <= i2; ++k)
+    {
+        if (i1 & 1)
+        {
+            const Bucket b = bucket(k, i1++);
+            iLower = below(iLower, b.lower);
+            iUpper = above(iUpper, b.upper);
+        }
+        if (!(i2 & 1))
+        {
+            const Bucket b = bucket(k, i2--);
+            iLower = below(iLower, b.lower);
+            iUpper = above(iUpper, b.upper);
+        }
+
+        i1 >>= 1;
+        i2 >>= 1;
+    }
+
+    min = mY[iLower];
+    max = mY[iUpper];
+
+    return true;
+}
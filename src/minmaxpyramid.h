@@ -0,0 +1,76 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <QVector>
+
+// Multi-resolution summary of a plotted series. Level k splits the samples
+// into buckets of 2^k and keeps the index of the lowest and highest value
+// in each, so any range can be drawn from about as many points as it has
+// pixels without losing peaks, and the extremes of any range found in
+// logarithmic time. The x values must be non-decreasing.
+
+class MinMaxPyramid
+{
+public:
+    MinMaxPyramid();
+    MinMaxPyramid(const QVector< double > &x, const QVector< double > &y);
+
+    bool isEmpty() const { return mX.isEmpty(); }
+    int size() const { return mX.size(); }
+
+    // Points needed to draw [lower, upper] across the given width in
+    // pixels, including one sample beyond each end. Every sample is
+    // returned when there are few enough; otherwise the extremes of
+    // buckets no wider than half a pixel, in their original order.
+    void sample(double lower, double upper, int pixels,
+                QVector< double > &x, QVector< double > &y) const;
+
+    // Lowest and highest values of the samples within [lower, upper],
+    // combining whole buckets where possible. Returns false if there are
+    // no samples in the range.
+    bool extrema(double lower, double upper,
+                 double &min, double &max) const;
+
+    // As above, for samples first to last inclusive
+    bool sampleExtrema(int first, int last,
+                       double &min, double &max) const;
+
+private:
+    typedef struct {
+        int lower;
+        int upper;
+    } Bucket;
+
+    QVector< double >               mX, mY;
+    QVector< QVector< Bucket > >    mLevels;    // Starting at level 1
+
+    int below(int i1, int i2) const;
+    int above(int i1, int i2) const;
+
+    Bucket bucket(int level, int j) const;
+};
+
+#endif // MINMAXPYRAMID_H
@@ -0,0 +1,341 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "batchsimulator.h"
+#include "cmaesoptimizer.h"
+#include "geneticoptimizer.h"
+#include "gradientoptimizer.h"
+#include "optimizer.h"
+
+#include <QtConcurrent>
+#include <QThreadStorage>
+
+namespace
+{
+
+const int batchSize = 8;            // Individuals scored together
+
+// Simulation state kept by each worker thread
+class Workspace
+{
+public:
+    Workspace(): owner(0) {}
+    ~Workspace() { qDeleteAll(evaluators); }
+
+    Trajectory trajectories[batchSize];
+    QVector< FitnessEvaluator * > evaluators;
+    BatchSimulator simulator;
+    int owner;
+};
+
+QThreadStorage< Workspace * > workspaces;
+QAtomicInt nextId(1);
+
+} // namespace
+
+// Scores one batch of individuals
+class Optimizer::BatchScorer
+{
+public:
+    typedef void result_type;
+
+    BatchScorer(Optimizer *optimizer, Score *scores, int count):
+        mOptimizer(optimizer), mScores(scores), mCount(count) {}
+
+    void operator()(int &first) const
+    {
+        mOptimizer->evaluateBatch(mScores + first,
+                                  qMin(batchSize, mCount - first));
+    }
+
+private:
+    Optimizer  *mOptimizer;
+    Score      *mScores;
+    int         mCount;
+};
+
+Optimizer::Optimizer(
+        FitnessFunction *function,
+        const Parameters &params,
+        QObject *parent):
+    QObject(parent),
+    mFunction(function),
+    mParams(params),
+    mDt(0.25),
+    mId(nextId.fetchAndAddOrdered(1)),
+    mProgress(0),
+    mCancel(0),
+    mEvaluations(0),
+    mLookups(0),
+    mHits(0),
+    mBestScore(0)
+{
+    int kLim = 0;
+    while (mDt * (1 << kLim) < mParams.simulationTime)
+    {
+        ++kLim;
+    }
+
+    mGenomeSize = (1 << kLim) + 1;
+    mKMin = kLim - 4;
+    mKMax = kLim - 2;
+}
+
+Optimizer *Optimizer::create(
+        Algorithm algorithm,
+        FitnessFunction *function,
+        const Parameters &params,
+        QObject *parent)
+{
+    switch (algorithm)
+    {
+    case CMAES:
+        return new CmaesOptimizer(function, params, parent);
+    case Gradient:
+        return new GradientOptimizer(function, params, parent);
+    default: // Genetic
+        return new GeneticOptimizer(function, params, parent);
+    }
+}
+
+int Optimizer::progress() const
+{
+    return mProgress.load();
+}
+
+double Optimizer::bestScore() const
+{
+    QMutexLocker locker(&mMutex);
+    return mBestScore;
+}
+
+double Optimizer::cacheHitRate() const
+{
+    const int lookups = mLookups.load();
+    return (lookups > 0) ? (double) mHits.load() / lookups : 0;
+}
+
+int Optimizer::evaluations() const
+{
+    return mEvaluations.load();
+}
+
+int Optimizer::evaluationsToConvergence() const
+{
+    QMutexLocker locker(&mMutex);
+
+    const double threshold = mBestScore - 0.001 * fabs(mBestScore);
+    for (int i = 0; i < mHistory.size(); ++i)
+    {
+        if (mHistory[i].second >= threshold)
+        {
+            return mHistory[i].first;
+        }
+    }
+
+    return mEvaluations.load();
+}
+
+void Optimizer::cancel()
+{
+    mCancel.store(1);
+}
+
+void Optimizer::start()
+{
+    mProgress.store(0);
+    mEvaluations.store(0);
+    mLookups.store(0);
+    mHits.store(0);
+
+    QMutexLocker locker(&mMutex);
+    mBestScore = 0;
+    mHistory.clear();
+    locker.unlock();
+
+    // Scores stay valid while the simulation parameters are unchanged
+    mFunction->fitnessCache()->setContext(context());
+}
+
+FitnessCache::Key Optimizer::context() const
+{
+    FitnessCache::Hasher hasher;
+
+    const DataPoint &dp0 = mParams.dp0;
+
+    hasher.add((quint64) dp0.hasGeodetic);
+    hasher.add(dp0.t);
+    hasher.add(dp0.x);
+    hasher.add(dp0.y);
+    hasher.add(dp0.z);
+    hasher.add(dp0.hMSL);
+    hasher.add(dp0.vx);
+    hasher.add(dp0.vy);
+    hasher.add(dp0.velD);
+    hasher.add(dp0.dist2D);
+    hasher.add(dp0.dist3D);
+    hasher.add(dp0.lift);
+    hasher.add(dp0.drag);
+
+    hasher.add(mParams.windowBottom);
+    hasher.add(mParams.a);
+    hasher.add(mParams.c);
+    hasher.add(mParams.planformArea);
+    hasher.add(mParams.mass);
+    hasher.add(mDt);
+
+    return hasher.result();
+}
+
+void Optimizer::evaluate(
+        GenePool &genePool)
+{
+    QList< int > batches;
+    for (int i = 0; i < genePool.size(); i += batchSize)
+    {
+        batches.append(i);
+    }
+
+    QtConcurrent::blockingMap(batches, BatchScorer(this, genePool.data(),
+                                                   genePool.size()));
+
+    mEvaluations.fetchAndAddRelaxed(genePool.size());
+}
+
+void Optimizer::evaluateBatch(
+        Score *scores,
+        int count)
+{
+    // Each worker thread simulates into its own buffer, so only the first
+    // few simulations on a thread allocate
+    if (!workspaces.hasLocalData())
+    {
+        workspaces.setLocalData(new Workspace);
+    }
+
+    Workspace &workspace = *workspaces.localData();
+    if (workspace.owner != mId)
+    {
+        qDeleteAll(workspace.evaluators);
+        workspace.evaluators.clear();
+
+        for (int i = 0; i < batchSize; ++i)
+        {
+            FitnessEvaluator *evaluator = mFunction->createEvaluator();
+            if (!evaluator) break;
+            workspace.evaluators.append(evaluator);
+        }
+
+        workspace.owner = mId;
+    }
+
+    FitnessEvaluator *const *evaluators =
+            workspace.evaluators.isEmpty() ? 0 : workspace.evaluators.constData();
+
+    // Look up genomes which have been scored before
+    FitnessCache *cache = mFunction->fitnessCache();
+
+    FitnessCache::Key keys[batchSize];
+    const Genome *genomes[batchSize];
+    int pending[batchSize];
+    int numPending = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        keys[i] = FitnessCache::key(scores[i].second);
+        if (!cache->find(keys[i], scores[i].first))
+        {
+            genomes[numPending] = &scores[i].second;
+            pending[numPending++] = i;
+        }
+    }
+
+    mLookups.fetchAndAddRelaxed(count);
+    mHits.fetchAndAddRelaxed(count - numPending);
+
+    if (numPending == 0) return;
+
+    // Simulate the rest
+    if (mParams.simulator == Batched)
+    {
+        workspace.simulator.simulate(mDt, mParams.a, mParams.c,
+                                     mParams.planformArea, mParams.mass,
+                                     mParams.dp0, mParams.windowBottom,
+                                     genomes, numPending,
+                                     workspace.trajectories, evaluators);
+    }
+    else
+    {
+        for (int j = 0; j < numPending; ++j)
+        {
+            genomes[j]->simulate(mDt, mParams.a, mParams.c,
+                                 mParams.planformArea, mParams.mass,
+                                 mParams.dp0, mParams.windowBottom,
+                                 workspace.trajectories[j],
+                                 evaluators ? evaluators[j] : 0);
+        }
+    }
+
+    for (int j = 0; j < numPending; ++j)
+    {
+        double score;
+        if (evaluators)
+        {
+            score = evaluators[j]->score();
+        }
+        else
+        {
+            // Fall back on scoring data points
+            score = mFunction->score(workspace.trajectories[j].toDataPoints());
+        }
+
+        scores[pending[j]].first = score;
+        cache->insert(keys[pending[j]], score);
+    }
+}
+
+void Optimizer::setBestScore(
+        const GenePool &genePool)
+{
+    QMutexLocker locker(&mMutex);
+
+    double maxScore = mBestScore;
+    for (int i = 0; i < genePool.size(); ++i)
+    {
+        maxScore = qMax(maxScore, genePool[i].first);
+    }
+
+    if (maxScore > mBestScore)
+    {
+        mBestScore = maxScore;
+        mHistory.append(QPair< int, double >(mEvaluations.load(), maxScore));
+    }
+}
+
+QVector< DataPoint > Optimizer::simulate(
+        const Genome &genome) const
+{
+    return genome.simulate(mDt, mParams.a, mParams.c,
+                           mParams.planformArea, mParams.mass,
+                           mParams.dp0, mParams.windowBottom);
+}
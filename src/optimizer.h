@@ -0,0 +1,141 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QVector>
+
+#include "datapoint.h"
+#include "fitnesscache.h"
+#include "fitnessfunction.h"
+#include "genome.h"
+
+typedef QPair< double, Genome > Score;
+typedef QVector< Score > GenePool;
+
+static bool operator<(const Score &s1, const Score &s2)
+{
+    return s1.first > s2.first;
+}
+
+// Base class for lift coefficient optimizers. Handles cancellation, progress
+// and scoring of candidates, which is done in parallel using the fitness
+// cache and the selected simulator. Subclasses implement the search itself.
+
+class Optimizer : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef enum {
+        Genetic, CMAES, Gradient
+    } Algorithm;
+
+    typedef enum {
+        Scalar, Batched
+    } Simulator;
+
+    typedef struct {
+        DataPoint dp0;              // Initial state
+        double    windowBottom;     // Simulation stops below this elevation
+        double    a, c;             // Drag polar, cd = a * cl^2 + c
+        double    minLift, maxLift;
+        double    planformArea;
+        double    mass;
+        int       simulationTime;   // Maximum duration of simulation (s)
+        quint64   seed;
+        Simulator simulator;
+    } Parameters;
+
+    Optimizer(FitnessFunction *function, const Parameters &params,
+              QObject *parent = 0);
+
+    static Optimizer *create(Algorithm algorithm,
+                             FitnessFunction *function, const Parameters &params,
+                             QObject *parent = 0);
+
+    // Run on the calling thread
+    virtual QVector< DataPoint > optimize() = 0;
+
+    int progress() const;
+    virtual int progressMaximum() const = 0;
+    double bestScore() const;
+
+    // Fraction of individuals scored from the fitness cache
+    double cacheHitRate() const;
+
+    // Individuals scored so far, and how many it took to come within 0.1%
+    // of the best score
+    int evaluations() const;
+    int evaluationsToConvergence() const;
+
+public slots:
+    void cancel();
+
+protected:
+    FitnessFunction    *mFunction;
+    Parameters          mParams;
+
+    double              mDt;
+    int                 mGenomeSize;
+    int                 mKMin, mKMax;
+
+    // Reset counters before optimizing
+    void start();
+
+    bool isCanceled() const { return mCancel.load() != 0; }
+    void addProgress(int count) { mProgress.fetchAndAddRelaxed(count); }
+
+    // Score every individual in the gene pool
+    void evaluate(GenePool &genePool);
+    void setBestScore(const GenePool &genePool);
+
+    QVector< DataPoint > simulate(const Genome &genome) const;
+
+private:
+    class BatchScorer;
+    friend class BatchScorer;
+
+    int                 mId;
+
+    QAtomicInt          mProgress;
+    QAtomicInt          mCancel;
+
+    QAtomicInt          mEvaluations;
+    QAtomicInt          mLookups;
+    QAtomicInt          mHits;
+
+    mutable QMutex      mMutex;
+    double              mBestScore;
+    QVector< QPair< int, double > > mHistory;
+
+    FitnessCache::Key context() const;
+    void evaluateBatch(Score *scores, int count);
+};
+
+#endif // OPTIMIZER_H
@@ -29,6 +29,7 @@
 
 #include "common.h"
 #include "mainwindow.h"
+#include "profiler.h"
 
 #define WINDOW_MARGIN 1.2
 #define MIN_ARROW_LEN 0.2
@@ -169,6 +170,8 @@ void OrthoView::endTimer()
 
 void OrthoView::updateView()
 {
+    ProfileScope scope("OrthoView::updateView");
+
     clearPlottables();
     clearItems();
 
@@ -68,7 +68,7 @@ void PerformanceScoring::prepareDataPlot(
         yElev << plot->yValue(DataPlot::Elevation)->value(dpStart, mMainWindow->units())
               << plot->yValue(DataPlot::Elevation)->value(dpStart, mMainWindow->units());
 
-        QCPGraph *graph = plot->addGraph(
+        QCPGraph *graph = plot->annotationGraph(
                     plot->axisRect()->axis(QCPAxis::atBottom),
                     plot->yValue(DataPlot::Elevation)->axis());
         graph->setData(xElev, yElev);
@@ -78,13 +78,13 @@ void PerformanceScoring::prepareDataPlot(
         yElev << plot->yValue(DataPlot::Elevation)->value(dpEnd, mMainWindow->units())
               << plot->yValue(DataPlot::Elevation)->value(dpEnd, mMainWindow->units());
 
-        graph = plot->addGraph(
+        graph = plot->annotationGraph(
                     plot->axisRect()->axis(QCPAxis::atBottom),
                     plot->yValue(DataPlot::Elevation)->axis());
         graph->setData(xElev, yElev);
         graph->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
 
-        QCPItemRect *rect = new QCPItemRect(plot);
+        QCPItemRect *rect = plot->annotationRect();
 
         rect->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
         rect->setBrush(QColor(0, 0, 0, 8));
@@ -99,7 +99,7 @@ void PerformanceScoring::prepareDataPlot(
                     (plot->xValue()->value(dpStart, mMainWindow->units()) - xMin) / (xMax - xMin),
                     1.1);
 
-        rect = new QCPItemRect(plot);
+        rect = plot->annotationRect();
 
         rect->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
         rect->setBrush(QColor(0, 0, 0, 8));
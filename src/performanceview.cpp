@@ -0,0 +1,251 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include <QCheckBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSettings>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include "performanceview.h"
+#include "profiler.h"
+
+namespace
+{
+
+typedef enum {
+    Name, Calls, Mean, Median, P95, Maximum, Histogram, NumColumns
+} Column;
+
+QString milliseconds(
+        qint64 ns)
+{
+    return QString::number(ns / 1e6, 'f', 3);
+}
+
+// One block character per histogram bin, scaled to the fullest bin
+QString sparkline(
+        const Profiler::Timer &timer,
+        int &first,
+        int &last)
+{
+    first = 0;
+    while (first < Profiler::NumBins - 1 && timer.bins[first] == 0) ++first;
+
+    last = Profiler::NumBins - 1;
+    while (last > first && timer.bins[last] == 0) --last;
+
+    qint64 maxCount = 0;
+    for (int i = first; i <= last; ++i)
+    {
+        maxCount = qMax(maxCount, timer.bins[i]);
+    }
+
+    QString text;
+    for (int i = first; i <= last; ++i)
+    {
+        if (timer.bins[i] == 0)
+        {
+            text += QChar(' ');
+        }
+        else
+        {
+            // U+2581 to U+2588 are lower one eighth to full block
+            const int level = (int) ((timer.bins[i] * 7) / maxCount);
+            text += QChar(0x2581 + level);
+        }
+    }
+
+    return text;
+}
+
+} // namespace
+
+PerformanceView::PerformanceView(QWidget *parent) :
+    QWidget(parent)
+{
+    mRecord = new QCheckBox(tr("Record"));
+    mRecord->setChecked(Profiler::instance()->isEnabled());
+
+    QPushButton *reset = new QPushButton(tr("Reset"));
+    QPushButton *save = new QPushButton(tr("Save Trace..."));
+
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addWidget(mRecord);
+    buttons->addStretch();
+    buttons->addWidget(reset);
+    buttons->addWidget(save);
+
+    mTable = new QTableWidget(0, NumColumns);
+    mTable->setHorizontalHeaderLabels(QStringList()
+                                      << tr("Name")
+                                      << tr("Calls")
+                                      << tr("Mean (ms)")
+                                      << tr("Median (ms)")
+                                      << tr("95% (ms)")
+                                      << tr("Max (ms)")
+                                      << tr("Histogram"));
+    mTable->verticalHeader()->setVisible(false);
+    mTable->horizontalHeader()->setStretchLastSection(true);
+    mTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    mTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addLayout(buttons);
+    layout->addWidget(mTable);
+    setLayout(layout);
+
+    connect(mRecord, SIGNAL(toggled(bool)),
+            this, SLOT(setRecording(bool)));
+    connect(reset, SIGNAL(clicked()),
+            this, SLOT(reset()));
+    connect(save, SIGNAL(clicked()),
+            this, SLOT(saveTrace()));
+
+    // Poll while visible
+    mTimer = new QTimer(this);
+    connect(mTimer, SIGNAL(timeout()),
+            this, SLOT(updateView()));
+}
+
+void PerformanceView::showEvent(
+        QShowEvent *event)
+{
+    updateView();
+    mTimer->start(500);
+    QWidget::showEvent(event);
+}
+
+void PerformanceView::hideEvent(
+        QHideEvent *event)
+{
+    mTimer->stop();
+    QWidget::hideEvent(event);
+}
+
+void PerformanceView::setRow(
+        int row,
+        const QString &name,
+        qint64 count)
+{
+    if (!mTable->item(row, 0))
+    {
+        for (int j = 0; j < NumColumns; ++j)
+        {
+            QTableWidgetItem *item = new QTableWidgetItem;
+            if (j != Name && j != Histogram)
+            {
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            }
+            mTable->setItem(row, j, item);
+        }
+    }
+
+    for (int j = 0; j < NumColumns; ++j)
+    {
+        mTable->item(row, j)->setText(QString());
+        mTable->item(row, j)->setToolTip(QString());
+    }
+
+    mTable->item(row, Name)->setText(name);
+    mTable->item(row, Calls)->setText(QString::number(count));
+}
+
+void PerformanceView::updateView()
+{
+    const QList< Profiler::Timer > timers = Profiler::instance()->timers();
+    const QMap< QByteArray, qint64 > counters = Profiler::instance()->counters();
+
+    mTable->setRowCount(timers.size() + counters.size());
+
+    int row = 0;
+    for (int i = 0; i < timers.size(); ++i, ++row)
+    {
+        const Profiler::Timer &timer = timers[i];
+
+        setRow(row, QString::fromLatin1(timer.name), timer.count);
+
+        const qint64 mean = (timer.count > 0) ? timer.total / timer.count : 0;
+        mTable->item(row, Mean)->setText(milliseconds(mean));
+        mTable->item(row, Median)->setText(milliseconds(Profiler::percentile(timer, 0.5)));
+        mTable->item(row, P95)->setText(milliseconds(Profiler::percentile(timer, 0.95)));
+        mTable->item(row, Maximum)->setText(milliseconds(timer.maximum));
+
+        int first, last;
+        QTableWidgetItem *item = mTable->item(row, Histogram);
+        item->setText(sparkline(timer, first, last));
+        item->setToolTip(tr("%1 ms to %2 ms")
+                         .arg(milliseconds(Profiler::binStart(first)))
+                         .arg(milliseconds(Profiler::binStart(last + 1))));
+    }
+
+    // Counters only have totals
+    QMap< QByteArray, qint64 >::const_iterator it;
+    for (it = counters.constBegin(); it != counters.constEnd(); ++it, ++row)
+    {
+        setRow(row, QString::fromLatin1(it.key()), it.value());
+    }
+}
+
+void PerformanceView::setRecording(
+        bool recording)
+{
+    Profiler::instance()->setEnabled(recording);
+}
+
+void PerformanceView::reset()
+{
+    Profiler::instance()->clear();
+    updateView();
+}
+
+void PerformanceView::saveTrace()
+{
+    // Initialize settings object
+    QSettings settings("FlySight", "Viewer");
+
+    // Get last file written
+    QString rootFolder = settings.value("traceFolder").toString();
+
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                    tr("Save Trace"),
+                                                    rootFolder,
+                                                    tr("Trace Files (*.json)"));
+
+    if (fileName.isEmpty()) return;
+
+    // Remember last file written
+    settings.setValue("traceFolder", QFileInfo(fileName).absoluteFilePath());
+
+    if (!Profiler::instance()->writeTrace(fileName))
+    {
+        QMessageBox::critical(this, tr("Save failed"),
+                              tr("Could not write %1").arg(fileName));
+    }
+}
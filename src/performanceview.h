@@ -0,0 +1,63 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef PERFORMANCEVIEW_H
+#define PERFORMANCEVIEW_H
+
+#include <QWidget>
+
+class QCheckBox;
+class QTableWidget;
+class QTimer;
+
+// Latency histograms and call counts from the profiler, refreshed while
+// the view is visible
+
+class PerformanceView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PerformanceView(QWidget *parent = 0);
+
+protected:
+    void showEvent(QShowEvent *event);
+    void hideEvent(QHideEvent *event);
+
+private:
+    QCheckBox    *mRecord;
+    QTableWidget *mTable;
+    QTimer       *mTimer;
+
+    void setRow(int row, const QString &name, qint64 count);
+
+public slots:
+    void updateView();
+
+private slots:
+    void setRecording(bool recording);
+    void reset();
+    void saveTrace();
+};
+
+#endif // PERFORMANCEVIEW_H
@@ -28,6 +28,7 @@
 
 #include "common.h"
 #include "mainwindow.h"
+#include "profiler.h"
 
 #define INTERVAL 250    // Timer interval in ms
 
@@ -155,6 +156,8 @@ void PlaybackView::setPosition(int position)
 
 void PlaybackView::updateView()
 {
+    ProfileScope scope("PlaybackView::updateView");
+
     if (mBusy || !mMainWindow) return;
 
     if (mMainWindow->dataSize() > 0)
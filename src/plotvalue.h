@@ -27,6 +27,7 @@
 #include <QColor>
 #include <QSettings>
 #include <QString>
+#include <QVector>
 
 #include "QCustomPlot/qcustomplot.h"
 
@@ -77,6 +78,23 @@ public:
         return 1;
     }
 
+    // Batch form of value() for count samples starting at dp
+    virtual void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        const double f = factor(units);
+        for (int i = 0; i < count; ++i)
+        {
+            out[i] = rawValue(dp[i]) * f;
+        }
+    }
+
+    QVector< double > values(const QVector< DataPoint > &data, Units units) const
+    {
+        QVector< double > result(data.size());
+        evaluate(data.constData(), data.size(), units, result.data());
+        return result;
+    }
+
     void setMinimum(double minimum) { mMinimum = minimum; }
     double minimum() const { return mMinimum; }
 
@@ -92,13 +110,17 @@ public:
     QCPAxis *addAxis(QCustomPlot *plot, Units units)
     {
         mAxis = plot->axisRect()->addAxis(QCPAxis::atLeft);
+        updateAxis(units);
+        return mAxis;
+    }
+    void updateAxis(Units units)
+    {
         mAxis->setLabelColor(color());
         mAxis->setTickLabelColor(color());
         mAxis->setBasePen(QPen(color()));
         mAxis->setTickPen(QPen(color()));
         mAxis->setSubTickPen(QPen(color()));
         mAxis->setLabel(title(units));
-        return mAxis;
     }
     QCPAxis *axis() const { return mAxis; }
 
@@ -133,6 +155,18 @@ public:
 
     virtual bool hasOptimal() const { return false; }
 
+protected:
+    // Loop for subclasses whose values come straight from a DataPoint
+    // accessor, so the accessor can be inlined
+    template< double (*Accessor)(const DataPoint &) >
+    static void evaluateWith(const DataPoint *dp, int count, double factor, double *out)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            out[i] = Accessor(dp[i]) * factor;
+        }
+    }
+
 private:
     bool     mVisible;
     QColor   mColor;
@@ -166,6 +200,10 @@ public:
     {
         return DataPoint::elevation(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::elevation >(dp, count, factor(units), out);
+    }
     double factor(Units units) const
     {
         return (units == Metric) ? 1
@@ -194,6 +232,10 @@ public:
     {
         return DataPoint::verticalSpeed(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::verticalSpeed >(dp, count, factor(units), out);
+    }
     double factor(Units units) const
     {
         return (units == Metric) ? MPS_TO_KMH
@@ -222,6 +264,10 @@ public:
     {
         return DataPoint::horizontalSpeed(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::horizontalSpeed >(dp, count, factor(units), out);
+    }
     double factor(Units units) const
     {
         return (units == Metric) ? MPS_TO_KMH
@@ -250,6 +296,10 @@ public:
     {
         return DataPoint::totalSpeed(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::totalSpeed >(dp, count, factor(units), out);
+    }
     double factor(Units units) const
     {
         return (units == Metric) ? MPS_TO_KMH
@@ -278,6 +328,10 @@ public:
     {
         return DataPoint::diveAngle(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::diveAngle >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return true; }
 };
@@ -301,6 +355,10 @@ public:
     {
         return DataPoint::curvature(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::curvature >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return true; }
 };
@@ -324,6 +382,10 @@ public:
     {
         return DataPoint::glideRatio(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::glideRatio >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return true; }
 };
@@ -347,6 +409,10 @@ public:
     {
         return DataPoint::horizontalAccuracy(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::horizontalAccuracy >(dp, count, factor(units), out);
+    }
     double factor(Units units) const
     {
         return (units == Metric) ? 1
@@ -373,6 +439,10 @@ public:
     {
         return DataPoint::verticalAccuracy(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::verticalAccuracy >(dp, count, factor(units), out);
+    }
     double factor(Units units) const
     {
         return (units == Metric) ? 1
@@ -399,6 +469,10 @@ public:
     {
         return DataPoint::speedAccuracy(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::speedAccuracy >(dp, count, factor(units), out);
+    }
     double factor(Units units) const
     {
         return (units == Metric) ? MPS_TO_KMH
@@ -425,6 +499,10 @@ public:
     {
         return DataPoint::numberOfSatellites(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::numberOfSatellites >(dp, count, factor(units), out);
+    }
 };
 
 class PlotTime: public PlotValue
@@ -446,6 +524,10 @@ public:
     {
         return DataPoint::time(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::time >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return true; }
 };
@@ -469,6 +551,10 @@ public:
     {
         return DataPoint::distance2D(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::distance2D >(dp, count, factor(units), out);
+    }
     double factor(Units units) const
     {
         return (units == Metric) ? 1
@@ -497,6 +583,10 @@ public:
     {
         return DataPoint::distance3D(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::distance3D >(dp, count, factor(units), out);
+    }
     double factor(Units units) const
     {
         return (units == Metric) ? 1
@@ -525,6 +615,10 @@ public:
     {
         return DataPoint::acceleration(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::acceleration >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return true; }
 };
@@ -548,6 +642,10 @@ public:
     {
         return DataPoint::totalEnergy(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::totalEnergy >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return true; }
 };
@@ -571,6 +669,10 @@ public:
     {
         return DataPoint::energyRate(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::energyRate >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return true; }
 };
@@ -594,6 +696,10 @@ public:
     {
         return DataPoint::liftCoefficient(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::liftCoefficient >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return true; }
 };
@@ -617,6 +723,10 @@ public:
     {
         return DataPoint::dragCoefficient(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::dragCoefficient >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return true; }
 };
@@ -640,6 +750,10 @@ public:
     {
         return DataPoint::course(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::course >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return false; }
 };
@@ -663,6 +777,10 @@ public:
     {
         return DataPoint::courseRate(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::courseRate >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return false; }
 };
@@ -686,6 +804,10 @@ public:
     {
         return DataPoint::courseAccuracy(dp);
     }
+    void evaluate(const DataPoint *dp, int count, Units units, double *out) const
+    {
+        evaluateWith< DataPoint::courseAccuracy >(dp, count, factor(units), out);
+    }
 
     bool hasOptimal() const { return false; }
 };
@@ -24,6 +24,40 @@
 #include "ppcscoring.h"
 
 #include "mainwindow.h"
+#include "scoringrules.h"
+#include "trajectory.h"
+
+namespace
+{
+
+class PPCEvaluator : public WindowEvaluator
+{
+public:
+    PPCEvaluator(PPCScoring::Mode mode, double windowTop, double windowBottom):
+        WindowEvaluator(windowTop, windowBottom), mMode(mode) {}
+
+protected:
+    double score(const Crossing &top, const Crossing &bottom) const
+    {
+        const double dx = bottom.x - top.x;
+        const double dy = bottom.y - top.y;
+
+        switch (mMode)
+        {
+        case PPCScoring::Time:
+            return bottom.t - top.t;
+        case PPCScoring::Distance:
+            return sqrt(dx * dx + dy * dy);
+        default: // Speed
+            return sqrt(dx * dx + dy * dy) / (bottom.t - top.t);
+        }
+    }
+
+private:
+    PPCScoring::Mode mMode;
+};
+
+} // namespace
 
 PPCScoring::PPCScoring(
         MainWindow *mainWindow):
@@ -61,17 +95,22 @@ double PPCScoring::score(
         switch (mMode)
         {
         case Time:
-            return dpBottom.t - dpTop.t;
+            return ScoringRules::ppcTime(dpTop, dpBottom);
         case Distance:
-            return MainWindow::getDistance(dpTop, dpBottom);
+            return ScoringRules::ppcDistance(dpTop, dpBottom);
         default: // Speed
-            return MainWindow::getDistance(dpTop, dpBottom) / (dpBottom.t - dpTop.t);
+            return ScoringRules::ppcSpeed(dpTop, dpBottom);
         }
     }
 
     return 0;
 }
 
+FitnessEvaluator *PPCScoring::createEvaluator() const
+{
+    return new PPCEvaluator(mMode, mWindowTop, mWindowBottom);
+}
+
 QString PPCScoring::scoreAsText(
         double score)
 {
@@ -124,7 +163,7 @@ void PPCScoring::prepareDataPlot(
         yElev << plot->yValue(DataPlot::Elevation)->value(dpTop, mMainWindow->units())
               << plot->yValue(DataPlot::Elevation)->value(dpTop, mMainWindow->units());
 
-        QCPGraph *graph = plot->addGraph(
+        QCPGraph *graph = plot->annotationGraph(
                     plot->axisRect()->axis(QCPAxis::atBottom),
                     plot->yValue(DataPlot::Elevation)->axis());
         graph->setData(xElev, yElev);
@@ -134,13 +173,13 @@ void PPCScoring::prepareDataPlot(
         yElev << plot->yValue(DataPlot::Elevation)->value(dpBottom, mMainWindow->units())
               << plot->yValue(DataPlot::Elevation)->value(dpBottom, mMainWindow->units());
 
-        graph = plot->addGraph(
+        graph = plot->annotationGraph(
                     plot->axisRect()->axis(QCPAxis::atBottom),
                     plot->yValue(DataPlot::Elevation)->axis());
         graph->setData(xElev, yElev);
         graph->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
 
-        QCPItemRect *rect = new QCPItemRect(plot);
+        QCPItemRect *rect = plot->annotationRect();
 
         rect->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
         rect->setBrush(QColor(0, 0, 0, 8));
@@ -155,7 +194,7 @@ void PPCScoring::prepareDataPlot(
                     (plot->xValue()->value(dpTop, mMainWindow->units()) - xMin) / (xMax - xMin),
                     1.1);
 
-        rect = new QCPItemRect(plot);
+        rect = plot->annotationRect();
 
         rect->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
         rect->setBrush(QColor(0, 0, 0, 8));
@@ -177,50 +216,5 @@ bool PPCScoring::getWindowBounds(
         DataPoint &dpBottom,
         DataPoint &dpTop)
 {
-    bool foundBottom = false;
-    bool foundTop = false;
-    int bottom, top;
-
-    for (int i = result.size() - 1; i >= 0; --i)
-    {
-        const DataPoint &dp = result[i];
-
-        if (dp.z < mWindowBottom)
-        {
-            bottom = i;
-            foundBottom = true;
-        }
-
-        if (dp.z < mWindowTop)
-        {
-            top = i;
-            foundTop = false;
-        }
-
-        if (dp.z > mWindowTop)
-        {
-            foundTop = true;
-        }
-
-        if (dp.t < 0) break;
-    }
-
-    if (foundBottom && foundTop)
-    {
-        // Calculate bottom of window
-        const DataPoint &dp1 = result[bottom - 1];
-        const DataPoint &dp2 = result[bottom];
-        dpBottom = DataPoint::interpolate(dp1, dp2, (mWindowBottom - dp1.z) / (dp2.z - dp1.z));
-
-        // Calculate top of window
-        const DataPoint &dp3 = result[top - 1];
-        const DataPoint &dp4 = result[top];
-        dpTop = DataPoint::interpolate(dp3, dp4, (mWindowTop - dp3.z) / (dp4.z - dp3.z));
-
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    return ScoringRules::windowBounds(result, mWindowTop, mWindowBottom, dpBottom, dpTop);
 }
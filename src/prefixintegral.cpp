@@ -0,0 +1,67 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "prefixintegral.h"
+
+#include <QtNumeric>
+
+PrefixIntegral::PrefixIntegral()
+{
+
+}
+
+PrefixIntegral::PrefixIntegral(
+        const QVector< double > &t,
+        const QVector< double > &y):
+    mSum(t.size()),
+    mInvalid(t.size())
+{
+    if (t.isEmpty()) return;
+
+    mSum[0] = 0;
+    mInvalid[0] = 0;
+
+    for (int i = 1; i < t.size(); ++i)
+    {
+        const double area = (y[i - 1] + y[i]) / 2 * (t[i] - t[i - 1]);
+
+        if (qIsFinite(area))
+        {
+            mSum[i] = mSum[i - 1] + area;
+            mInvalid[i] = mInvalid[i - 1];
+        }
+        else
+        {
+            mSum[i] = mSum[i - 1];
+            mInvalid[i] = mInvalid[i - 1] + 1;
+        }
+    }
+}
+
+double PrefixIntegral::integral(
+        int first,
+        int last) const
+{
+    if (mInvalid[last] != mInvalid[first]) return qQNaN();
+    return mSum[last] - mSum[first];
+}
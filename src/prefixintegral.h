@@ -0,0 +1,51 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef PREFIXINTEGRAL_H
+#define PREFIXINTEGRAL_H
+
+#include <QVector>
+
+// Running trapezoid-rule integral of a series, so the area under any run
+// of samples takes a single subtraction. Intervals with a value which is
+// not finite are left out of the sums and counted instead, so that only
+// runs which include them come out as NaN.
+
+class PrefixIntegral
+{
+public:
+    PrefixIntegral();
+    PrefixIntegral(const QVector< double > &t, const QVector< double > &y);
+
+    bool isEmpty() const { return mSum.isEmpty(); }
+    int size() const { return mSum.size(); }
+
+    // Integral from sample first to sample last
+    double integral(int first, int last) const;
+
+private:
+    QVector< double >   mSum;
+    QVector< int >      mInvalid;
+};
+
+#endif // PREFIXINTEGRAL_H
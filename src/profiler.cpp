@@ -0,0 +1,224 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "profiler.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <math.h>
+#include <string.h>
+
+Profiler::Profiler():
+    mEnabled(0),
+    mNextEvent(0)
+{
+    mClock.start();
+}
+
+Profiler *Profiler::instance()
+{
+    static Profiler profiler;
+    return &profiler;
+}
+
+void Profiler::setEnabled(
+        bool enabled)
+{
+    mEnabled.store(enabled ? 1 : 0);
+}
+
+void Profiler::addTime(
+        const char *name,
+        qint64 start,
+        qint64 end)
+{
+    const qint64 duration = end - start;
+
+    QMutexLocker locker(&mMutex);
+
+    int i;
+    QHash< const char *, int >::const_iterator it = mIndex.constFind(name);
+    if (it != mIndex.constEnd())
+    {
+        i = it.value();
+    }
+    else
+    {
+        // The same name may be at different addresses in different files
+        for (i = 0; i < mTimers.size(); ++i)
+        {
+            if (mTimers[i].name == name) break;
+        }
+
+        if (i == mTimers.size())
+        {
+            Timer timer;
+            timer.name = name;
+            timer.count = 0;
+            timer.total = 0;
+            timer.maximum = 0;
+            memset(timer.bins, 0, sizeof(timer.bins));
+            mTimers.append(timer);
+        }
+
+        mIndex.insert(name, i);
+    }
+
+    Timer &timer = mTimers[i];
+    ++timer.count;
+    timer.total += duration;
+    timer.maximum = qMax(timer.maximum, duration);
+    ++timer.bins[bin(duration)];
+
+    // Keep the most recent calls for the trace
+    Event event;
+    event.name = name;
+    event.thread = (quintptr) QThread::currentThreadId();
+    event.start = start;
+    event.duration = duration;
+
+    if (mEvents.size() < MaxEvents) mEvents.append(event);
+    else                            mEvents[mNextEvent] = event;
+
+    mNextEvent = (mNextEvent + 1) % MaxEvents;
+}
+
+void Profiler::addCount(
+        const char *name,
+        qint64 count)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker locker(&mMutex);
+    mCounters[name] += count;
+}
+
+QList< Profiler::Timer > Profiler::timers() const
+{
+    QMutexLocker locker(&mMutex);
+    return mTimers.toList();
+}
+
+QMap< QByteArray, qint64 > Profiler::counters() const
+{
+    QMutexLocker locker(&mMutex);
+    return mCounters;
+}
+
+void Profiler::clear()
+{
+    QMutexLocker locker(&mMutex);
+
+    mIndex.clear();
+    mTimers.clear();
+    mCounters.clear();
+
+    mEvents.clear();
+    mNextEvent = 0;
+}
+
+bool Profiler::writeTrace(
+        const QString &fileName) const
+{
+    QMutexLocker locker(&mMutex);
+    const QVector< Event > events = mEvents;
+    const int first = (events.size() < MaxEvents) ? 0 : mNextEvent;
+    locker.unlock();
+
+    // Number threads in order of appearance
+    QHash< quintptr, int > threads;
+
+    QJsonArray traceEvents;
+    for (int j = 0; j < events.size(); ++j)
+    {
+        const Event &event = events[(first + j) % events.size()];
+
+        if (!threads.contains(event.thread))
+        {
+            threads.insert(event.thread, threads.size() + 1);
+        }
+
+        QJsonObject object;
+        object.insert("name", QString::fromLatin1(event.name));
+        object.insert("ph", QString("X"));
+        object.insert("ts", event.start / 1000.);
+        object.insert("dur", event.duration / 1000.);
+        object.insert("pid", 1);
+        object.insert("tid", threads.value(event.thread));
+        traceEvents.append(object);
+    }
+
+    QJsonObject root;
+    root.insert("traceEvents", traceEvents);
+    root.insert("displayTimeUnit", QString("ms"));
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+qint64 Profiler::percentile(
+        const Timer &timer,
+        double fraction)
+{
+    const qint64 target = (qint64) ceil(fraction * timer.count);
+
+    qint64 sum = 0;
+    for (int i = 0; i < NumBins; ++i)
+    {
+        sum += timer.bins[i];
+        if (sum >= target && sum > 0)
+        {
+            return qMin(binStart(i + 1), timer.maximum);
+        }
+    }
+
+    return timer.maximum;
+}
+
+qint64 Profiler::binStart(
+        int bin)
+{
+    return (bin == 0) ? 0 : (Q_INT64_C(1000) << bin);
+}
+
+int Profiler::bin(
+        qint64 duration)
+{
+    // Bin i holds durations from 2^i to 2^(i + 1) us
+    qint64 us = duration / 1000;
+
+    int i = 0;
+    while (us > 1 && i < NumBins - 1)
+    {
+        us >>= 1;
+        ++i;
+    }
+
+    return i;
+}
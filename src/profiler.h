@@ -0,0 +1,131 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+// Latency histograms, call counts and a trace of recent calls for
+// instrumented code. Time a function by putting a ProfileScope at the top
+// of its body. Names must be string literals, usually "Class::method".
+// Recording is off until enabled, e.g. from the Performance view.
+
+class Profiler
+{
+public:
+    static const int NumBins = 24;          // Powers of two from 1 us
+    static const int MaxEvents = 100000;    // Calls kept for the trace
+
+    typedef struct {
+        QByteArray name;
+        qint64     count;
+        qint64     total;                   // ns
+        qint64     maximum;                 // ns
+        qint64     bins[NumBins];           // Calls by duration
+    } Timer;
+
+    static Profiler *instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return mEnabled.load() != 0; }
+
+    // Nanoseconds since the profiler was created
+    qint64 now() const { return mClock.nsecsElapsed(); }
+
+    void addTime(const char *name, qint64 start, qint64 end);
+    void addCount(const char *name, qint64 count = 1);
+
+    QList< Timer > timers() const;
+    QMap< QByteArray, qint64 > counters() const;
+
+    void clear();
+
+    // Chrome trace event JSON, for chrome://tracing or Perfetto
+    bool writeTrace(const QString &fileName) const;
+
+    // Upper bound of the bin holding the given fraction of calls (ns)
+    static qint64 percentile(const Timer &timer, double fraction);
+
+    // Lower bound of a histogram bin (ns)
+    static qint64 binStart(int bin);
+
+private:
+    typedef struct {
+        const char *name;
+        quintptr    thread;
+        qint64      start;                  // ns
+        qint64      duration;               // ns
+    } Event;
+
+    Profiler();
+
+    QElapsedTimer                   mClock;
+    QAtomicInt                      mEnabled;
+
+    mutable QMutex                  mMutex;
+    QHash< const char *, int >      mIndex;
+    QVector< Timer >                mTimers;
+    QMap< QByteArray, qint64 >      mCounters;
+
+    QVector< Event >                mEvents;
+    int                             mNextEvent;
+
+    static int bin(qint64 duration);
+};
+
+// Times the enclosing block while the profiler is enabled
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char *name):
+        mName(name),
+        mStart(Profiler::instance()->isEnabled() ? Profiler::instance()->now() : -1) {}
+
+    ~ProfileScope()
+    {
+        if (mStart >= 0)
+        {
+            Profiler *profiler = Profiler::instance();
+            profiler->addTime(mName, mStart, profiler->now());
+        }
+    }
+
+private:
+    const char *mName;
+    qint64      mStart;
+
+    ProfileScope(const ProfileScope &);
+    ProfileScope &operator=(const ProfileScope &);
+};
+
+#endif // PROFILER_H
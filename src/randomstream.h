@@ -0,0 +1,73 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <QtGlobal>
+
+// Small, fast pseudo-random generator (SplitMix64). Independent streams are
+// derived from a seed and a pair of indices, so work can be split across
+// threads without sharing generator state and results depend only on the
+// seed.
+
+class RandomStream
+{
+public:
+    explicit RandomStream(quint64 seed):
+        mState(seed) {}
+
+    RandomStream(quint64 seed, quint64 stream, quint64 index):
+        mState(mix(mix(seed ^ mix(stream)) ^ index)) {}
+
+    quint64 next()
+    {
+        mState += Q_UINT64_C(0x9E3779B97F4A7C15);
+        return mix(mState);
+    }
+
+    // Uniform integer in [0, n)
+    int bounded(int n)
+    {
+        return (int) (next() % (quint64) n);
+    }
+
+    // Uniform double in [0, 1)
+    double uniform()
+    {
+        return (next() >> 11) * (1.0 / Q_UINT64_C(9007199254740992));
+    }
+
+    // SplitMix64 finalizer, also useful as a hash
+    static quint64 mix(quint64 z)
+    {
+        z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+        z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+        return z ^ (z >> 31);
+    }
+
+private:
+    quint64 mState;
+};
+
+#endif // RANDOMSTREAM_H
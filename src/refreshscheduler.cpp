@@ -0,0 +1,153 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include <QEvent>
+#include <QWidget>
+
+#include "profiler.h"
+#include "refreshscheduler.h"
+
+namespace
+{
+
+const int frameInterval = 16;   // ms
+
+} // namespace
+
+RefreshScheduler::RefreshScheduler(QObject *parent) :
+    QObject(parent)
+{
+    mTimer.setSingleShot(true);
+    connect(&mTimer, SIGNAL(timeout()), this, SLOT(flush()));
+
+    mLastFlush.start();
+}
+
+void RefreshScheduler::addView(
+        QWidget *view,
+        const char *dataSlot,
+        const char *rangeSlot,
+        const char *cursorSlot)
+{
+    View v;
+    v.view = view;
+    v.dataSlot = dataSlot;
+    v.rangeSlot = rangeSlot;
+    v.cursorSlot = cursorSlot;
+    v.pending = 0;
+    mViews.append(v);
+
+    // Catch up when a hidden view is shown
+    view->installEventFilter(this);
+}
+
+bool RefreshScheduler::eventFilter(
+        QObject *watched,
+        QEvent *event)
+{
+    if (event->type() == QEvent::Show)
+    {
+        for (int i = 0; i < mViews.size(); ++i)
+        {
+            if (mViews[i].view == watched && mViews[i].pending)
+            {
+                schedule();
+                break;
+            }
+        }
+    }
+
+    return QObject::eventFilter(watched, event);
+}
+
+void RefreshScheduler::setDataChanged()
+{
+    setChanged(Data);
+}
+
+void RefreshScheduler::setRangeChanged()
+{
+    setChanged(Range);
+}
+
+void RefreshScheduler::setCursorChanged()
+{
+    setChanged(Cursor);
+}
+
+void RefreshScheduler::setChanged(
+        Change change)
+{
+    for (int i = 0; i < mViews.size(); ++i)
+    {
+        mViews[i].pending |= change;
+    }
+
+    schedule();
+}
+
+void RefreshScheduler::schedule()
+{
+    if (mTimer.isActive()) return;
+
+    // Wait for the rest of the frame if we refreshed recently
+    mTimer.start(qMax(0, frameInterval - (int) mLastFlush.elapsed()));
+}
+
+void RefreshScheduler::flush()
+{
+    ProfileScope scope("RefreshScheduler::flush");
+
+    mTimer.stop();
+    mLastFlush.restart();
+
+    for (int i = 0; i < mViews.size(); )
+    {
+        View &v = mViews[i];
+
+        // Forget views which have been deleted
+        if (!v.view)
+        {
+            mViews.remove(i);
+            continue;
+        }
+
+        if (v.pending && v.view->isVisible())
+        {
+            QByteArray slot;
+            if      (v.pending & Data)  slot = v.dataSlot;
+            else if (v.pending & Range) slot = v.rangeSlot;
+            else                        slot = v.cursorSlot;
+
+            // Clear first, since the slot may report new changes
+            v.pending = 0;
+
+            if (!slot.isEmpty())
+            {
+                QMetaObject::invokeMethod(mViews[i].view, slot.constData());
+            }
+        }
+
+        ++i;
+    }
+}
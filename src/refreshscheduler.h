@@ -0,0 +1,87 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef REFRESHSCHEDULER_H
+#define REFRESHSCHEDULER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+class QWidget;
+
+// Collects data, range and cursor changes and refreshes each registered
+// view at most once per frame. Hidden views keep their pending changes
+// until they are shown again.
+
+class RefreshScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef enum {
+        Cursor = 0x01,      // Only the cursor or mark moved
+        Range  = 0x02,      // Visible range changed
+        Data   = 0x04       // Track data or settings changed
+    } Change;
+
+    explicit RefreshScheduler(QObject *parent = 0);
+
+    // Slots are method names, e.g. "updateView", or 0 to ignore a change.
+    // Only the slot for the largest pending change is called, so it must
+    // also handle the smaller ones.
+    void addView(QWidget *view, const char *dataSlot,
+                 const char *rangeSlot, const char *cursorSlot);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event);
+
+public slots:
+    void setDataChanged();
+    void setRangeChanged();
+    void setCursorChanged();
+
+    // Refresh visible views now
+    void flush();
+
+private:
+    typedef struct {
+        QPointer< QWidget > view;
+        QByteArray          dataSlot;
+        QByteArray          rangeSlot;
+        QByteArray          cursorSlot;
+        int                 pending;
+    } View;
+
+    QVector< View > mViews;
+    QTimer          mTimer;
+    QElapsedTimer   mLastFlush;
+
+    void setChanged(Change change);
+    void schedule();
+};
+
+#endif // REFRESHSCHEDULER_H
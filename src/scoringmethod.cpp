@@ -21,190 +21,117 @@
 **  Website: http://flysight.ca/                                          **
 ****************************************************************************/
 
+#include <QDateTime>
+#include <QEventLoop>
+#include <QFutureWatcher>
 #include <QProgressDialog>
+#include <QScopedPointer>
+#include <QtConcurrent>
+#include <QTimer>
 
 #include "mainwindow.h"
+#include "optimizer.h"
 #include "scoringmethod.h"
 
-ScoringMethod::ScoringMethod(QObject *parent) : QObject(parent)
+ScoringMethod::ScoringMethod(QObject *parent) :
+    QObject(parent),
+    mOptimizer(0),
+    mDialog(0)
 {
+    connect(this, SIGNAL(scoringChanged()), this, SLOT(clearFitnessCache()));
+}
 
+void ScoringMethod::clearFitnessCache()
+{
+    mFitnessCache.clear();
 }
 
 void ScoringMethod::optimize(
         MainWindow *mainWindow,
         double windowBottom)
 {
-    const DataPoint &dp0 = mainWindow->interpolateDataT(0);
+    // Build parameters from the current track and settings
+    Optimizer::Parameters params;
+
+    params.dp0 = mainWindow->interpolateDataT(0);
+    params.windowBottom = windowBottom;
 
     // y = ax^2 + c
     const double m = 1 / mainWindow->maxLD();
-    const double c = mainWindow->minDrag();
-    const double a = m * m / (4 * c);
-
-    const int workingSize    = 100;     // Working population
-    const int keepSize       = 10;      // Number of elites to keep
-    const int newSize        = 10;      // New genomes in first level
-    const int numGenerations = 250;     // Generations per level of detail
-    const int tournamentSize = 5;       // Number of individuals in a tournament
-    const int mutationRate   = 100;     // Frequency of mutations
-    const int truncationRate = 10;      // Frequency of truncations
+    params.c = mainWindow->minDrag();
+    params.a = m * m / (4 * params.c);
 
-    qsrand(QTime::currentTime().msec());
+    params.minLift = mainWindow->minLift();
+    params.maxLift = mainWindow->maxLift();
+    params.planformArea = mainWindow->planformArea();
+    params.mass = mainWindow->mass();
+    params.simulationTime = mainWindow->simulationTime();
 
-    const double dt = 0.25; // Time step (s)
+    params.seed = QDateTime::currentMSecsSinceEpoch();
+    params.simulator = mainWindow->batchSimulation() ? Optimizer::Batched
+                                                     : Optimizer::Scalar;
 
-    int kLim = 0;
-    while (dt * (1 << kLim) < mainWindow->simulationTime())
-    {
-        ++kLim;
-    }
+    // Algorithms are listed in the same order in both enums
+    const Optimizer::Algorithm algorithm =
+            (Optimizer::Algorithm) mainWindow->optimizationAlgorithm();
 
-    const int genomeSize = (1 << kLim) + 1;
-    const int kMin = kLim - 4;
-    const int kMax = kLim - 2;
+    QScopedPointer< Optimizer > optimizer(
+                Optimizer::create(algorithm, this, params));
 
-    GenePool genePool;
+    // Keep most fit individual
+    mainWindow->setOptimal(run(optimizer.data(), mainWindow));
+}
 
+MainWindow::DataPoints ScoringMethod::run(
+        Optimizer *optimizer,
+        QWidget *parent)
+{
     QProgressDialog progress("Initializing...",
                              "Abort",
                              0,
-                             (kMax - kMin + 1) * numGenerations * workingSize + workingSize,
-                             mainWindow);
+                             optimizer->progressMaximum(),
+                             parent);
     progress.setWindowModality(Qt::WindowModal);
 
-    double maxScore = 0;
-    bool abort = false;
-
-    // Add new individuals
-    for (int i = 0; i < workingSize; ++i)
-    {
-        progress.setValue(progress.value() + 1);
-        if (progress.wasCanceled())
-        {
-            abort = true;
-            break;
-        }
-
-        Genome g(genomeSize, kMin, mainWindow->minLift(), mainWindow->maxLift());
-        const MainWindow::DataPoints result = g.simulate(dt, a, c, mainWindow->planformArea(), mainWindow->mass(), dp0, windowBottom);
-        const double s = score(result);
-        genePool.append(Score(s, g));
-
-        maxScore = qMax(maxScore, s);
-    }
-
-    // Increasing levels of detail
-    for (int k = kMin; k <= kMax && !abort; ++k)
-    {
-        // Generations
-        for (int j = 0; j < numGenerations && !abort; ++j)
-        {
-            progress.setValue(progress.value() + keepSize);
-            if (progress.wasCanceled())
-            {
-                abort = true;
-                break;
-            }
-
-            // Sort gene pool by score
-            qSort(genePool);
-
-            // Elitism
-            GenePool newGenePool = genePool.mid(0, keepSize);
-
-            // Initialize score
-            maxScore = 0;
-            for (int i = 0; i < keepSize; ++i)
-            {
-                maxScore = qMax(maxScore, newGenePool[i].first);
-            }
-
-            // Add new individuals in first level
-            for (int i = 0; k == kMin && i < newSize; ++i)
-            {
-                progress.setValue(progress.value() + 1);
-                if (progress.wasCanceled())
-                {
-                    abort = true;
-                    break;
-                }
-
-                Genome g(genomeSize, kMin, mainWindow->minLift(), mainWindow->maxLift());
-                const MainWindow::DataPoints result = g.simulate(dt, a, c, mainWindow->planformArea(), mainWindow->mass(), dp0, windowBottom);
-                const double s = score(result);
-                newGenePool.append(Score(s, g));
-
-                maxScore = qMax(maxScore, s);
-            }
-
-            // Tournament selection
-            while (newGenePool.size() < workingSize)
-            {
-                progress.setValue(progress.value() + 1);
-                if (progress.wasCanceled())
-                {
-                    abort = true;
-                    break;
-                }
-
-                const Genome &p1 = selectGenome(genePool, tournamentSize);
-                const Genome &p2 = selectGenome(genePool, tournamentSize);
-                Genome g(p1, p2, k);
-
-                if (qrand() % 100 < truncationRate)
-                {
-                    g.truncate(k);
-                }
-                if (qrand() % 100 < mutationRate)
-                {
-                    g.mutate(k, kMin, mainWindow->minLift(), mainWindow->maxLift());
-                }
-
-                const MainWindow::DataPoints result = g.simulate(dt, a, c, mainWindow->planformArea(), mainWindow->mass(), dp0, windowBottom);
-                const double s = score(result);
-                newGenePool.append(Score(s, g));
-
-                maxScore = qMax(maxScore, s);
-            }
-
-            genePool = newGenePool;
-
-            // Show best score in progress dialog
-            QString labelText = scoreAsText(maxScore);
-            progress.setLabelText(QString("Optimizing (best score is ") +
-                                  labelText +
-                                  QString(")..."));
-        }
-    }
-
-    progress.setValue((kMax - kMin + 1) * numGenerations * workingSize + workingSize);
-
-    // Sort gene pool by score
-    qSort(genePool);
+    connect(&progress, SIGNAL(canceled()), optimizer, SLOT(cancel()));
+    mOptimizer = optimizer;
+    mDialog = &progress;
 
-    // Keep most fit individual
-    mainWindow->setOptimal(genePool[0].second.simulate(dt, a, c, mainWindow->planformArea(), mainWindow->mass(), dp0, windowBottom));
+    // Poll progress while the optimizer runs in the background
+    QTimer timer;
+    connect(&timer, SIGNAL(timeout()), this, SLOT(updateProgress()));
+    timer.start(100);
+
+    QEventLoop loop;
+    QFutureWatcher< MainWindow::DataPoints > watcher;
+    connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+
+    watcher.setFuture(QtConcurrent::run(optimizer, &Optimizer::optimize));
+    loop.exec();
+
+    timer.stop();
+    mOptimizer = 0;
+    mDialog = 0;
+
+    progress.setValue(optimizer->progressMaximum());
+
+    return watcher.result();
 }
 
-const Genome &ScoringMethod::selectGenome(
-        const GenePool &genePool,
-        const int tournamentSize)
+void ScoringMethod::updateProgress()
 {
-    int jMax;
-    double sMax;
-    bool first = true;
-
-    for (int i = 0; i < tournamentSize; ++i)
-    {
-        const int j = qrand() % genePool.size();
-        if (first || genePool[j].first > sMax)
-        {
-            jMax = j;
-            sMax = genePool[j].first;
-            first = false;
-        }
-    }
-
-    return genePool[jMax].second;
+    if (!mDialog) return;
+
+    mDialog->setValue(qMin(mOptimizer->progress(),
+                           mOptimizer->progressMaximum() - 1));
+
+    // Show best score, evaluations and cache hit rate in progress dialog
+    QString labelText = scoreAsText(mOptimizer->bestScore());
+    mDialog->setLabelText(QString("Optimizing (best score is ") +
+                          labelText +
+                          QString(" after ") +
+                          QString::number(mOptimizer->evaluationsToConvergence()) +
+                          QString(" evaluations, ") +
+                          QString::number(qRound(100 * mOptimizer->cacheHitRate())) +
+                          QString("% cached)..."));
 }
@@ -29,27 +29,24 @@
 #include <QVector>
 
 #include "datapoint.h"
-#include "genome.h"
+#include "fitnesscache.h"
+#include "fitnessevaluator.h"
+#include "fitnessfunction.h"
+#include "mainwindow.h"
 
 class DataPlot;
-class MainWindow;
 class MapView;
+class Optimizer;
+class QProgressDialog;
 
-typedef QPair< double, Genome > Score;
-typedef QVector< Score > GenePool;
-
-static bool operator<(const Score &s1, const Score &s2)
-{
-    return s1.first > s2.first;
-}
-
-class ScoringMethod : public QObject
+class ScoringMethod : public QObject, public FitnessFunction
 {
     Q_OBJECT
 public:
     explicit ScoringMethod(QObject *parent = 0);
 
     virtual double score(const MainWindow::DataPoints &result) { return 0; }
+    virtual FitnessEvaluator *createEvaluator() const { return 0; }
     virtual QString scoreAsText(double score) { return QString(); }
 
     virtual void prepareDataPlot(DataPlot *plot) {}
@@ -63,16 +60,29 @@ public:
     virtual void readSettings() {}
     virtual void writeSettings() {}
 
+    // Scores from previous optimizations, cleared when scoring changes
+    FitnessCache *fitnessCache() { return &mFitnessCache; }
+
 protected:
     void optimize(MainWindow *mainWindow, double windowBottom);
 
-private:
-    const Genome &selectGenome(const GenePool &genePool, const int tournamentSize);
-
 signals:
     void scoringChanged();
 
 public slots:
+
+private slots:
+    void clearFitnessCache();
+    void updateProgress();
+
+private:
+    FitnessCache     mFitnessCache;
+
+    Optimizer       *mOptimizer;
+    QProgressDialog *mDialog;
+
+    // Run with a progress dialog, keeping the GUI responsive
+    MainWindow::DataPoints run(Optimizer *optimizer, QWidget *parent);
 };
 
 #endif // SCORINGMETHOD_H
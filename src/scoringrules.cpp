@@ -0,0 +1,298 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "scoringrules.h"
+
+#include <math.h>
+
+#include "GeographicLib/Geodesic.hpp"
+
+#include "geographicutil.h"
+#include "kinematics.h"
+
+using namespace GeographicLib;
+using namespace GeographicUtil;
+
+namespace
+{
+
+double projectedDistance(
+        const ScoringRules::Lane &lane,
+        double startLat,
+        double startLon,
+        double lat,
+        double lon)
+{
+    // Get projected point
+    double lat0, lon0;
+    intercept(startLat, startLon, lane.endLatitude, lane.endLongitude, lat, lon, lat0, lon0);
+
+    // Distance from top
+    double topDist;
+    Geodesic::WGS84().Inverse(startLat, startLon, lat0, lon0, topDist);
+
+    // Distance from bottom
+    double bottomDist;
+    Geodesic::WGS84().Inverse(lane.endLatitude, lane.endLongitude, lat0, lon0, bottomDist);
+
+    if (topDist > bottomDist) return topDist;
+    else                      return lane.laneLength - bottomDist;
+}
+
+} // namespace
+
+double ScoringRules::distance(
+        const DataPoint &dp1,
+        const DataPoint &dp2)
+{
+    if (dp1.hasGeodetic && dp2.hasGeodetic)
+    {
+        const Geodesic &geod = Geodesic::WGS84();
+        double s12;
+
+        geod.Inverse(dp1.lat, dp1.lon, dp2.lat, dp2.lon, s12);
+
+        return s12;
+    }
+    else
+    {
+        const double dx = dp2.x - dp1.x;
+        const double dy = dp2.y - dp1.y;
+
+        return sqrt(dx * dx + dy * dy);
+    }
+}
+
+bool ScoringRules::windowBounds(
+        const DataPoints &data,
+        double windowTop,
+        double windowBottom,
+        DataPoint &dpBottom,
+        DataPoint &dpTop)
+{
+    bool foundBottom = false;
+    bool foundTop = false;
+    int bottom, top;
+
+    for (int i = data.size() - 1; i >= 0; --i)
+    {
+        const DataPoint &dp = data[i];
+
+        if (dp.z < windowBottom)
+        {
+            bottom = i;
+            foundBottom = true;
+        }
+
+        if (dp.z < windowTop)
+        {
+            top = i;
+            foundTop = false;
+        }
+
+        if (dp.z > windowTop)
+        {
+            foundTop = true;
+        }
+
+        if (dp.t < 0) break;
+    }
+
+    if (foundBottom && foundTop)
+    {
+        // Calculate bottom of window
+        const DataPoint &dp1 = data[bottom - 1];
+        const DataPoint &dp2 = data[bottom];
+        dpBottom = DataPoint::interpolate(dp1, dp2, (windowBottom - dp1.z) / (dp2.z - dp1.z));
+
+        // Calculate top of window
+        const DataPoint &dp3 = data[top - 1];
+        const DataPoint &dp4 = data[top];
+        dpTop = DataPoint::interpolate(dp3, dp4, (windowTop - dp3.z) / (dp4.z - dp3.z));
+
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool ScoringRules::windowBottom(
+        const DataPoints &data,
+        double windowBottom,
+        DataPoint &dpBottom)
+{
+    bool foundBottom = false;
+    int bottom;
+
+    for (int i = data.size() - 1; i >= 0; --i)
+    {
+        const DataPoint &dp = data[i];
+
+        if (dp.z < windowBottom)
+        {
+            bottom = i;
+            foundBottom = true;
+        }
+
+        if (dp.t < 0) break;
+    }
+
+    if (foundBottom)
+    {
+        // Calculate bottom of window
+        const DataPoint &dp1 = data[bottom - 1];
+        const DataPoint &dp2 = data[bottom];
+        dpBottom = DataPoint::interpolate(dp1, dp2, (windowBottom - dp1.z) / (dp2.z - dp1.z));
+
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+double ScoringRules::ppcTime(
+        const DataPoint &dpTop,
+        const DataPoint &dpBottom)
+{
+    return dpBottom.t - dpTop.t;
+}
+
+double ScoringRules::ppcDistance(
+        const DataPoint &dpTop,
+        const DataPoint &dpBottom)
+{
+    return distance(dpTop, dpBottom);
+}
+
+double ScoringRules::ppcSpeed(
+        const DataPoint &dpTop,
+        const DataPoint &dpBottom)
+{
+    return distance(dpTop, dpBottom) / (dpBottom.t - dpTop.t);
+}
+
+double ScoringRules::speed(
+        double windowTop,
+        double windowBottom,
+        const DataPoint &dpTop,
+        const DataPoint &dpBottom)
+{
+    return (windowTop - windowBottom) / (dpBottom.t - dpTop.t);
+}
+
+void ScoringRules::laneStart(
+        const Lane &lane,
+        double &lat,
+        double &lon)
+{
+    Geodesic::WGS84().Direct(lane.endLatitude, lane.endLongitude,
+                             lane.bearing, lane.laneLength, lat, lon);
+}
+
+double ScoringRules::laneDistance(
+        const Lane &lane,
+        double lat,
+        double lon)
+{
+    double startLat, startLon;
+    laneStart(lane, startLat, startLon);
+
+    return projectedDistance(lane, startLat, startLon, lat, lon);
+}
+
+ScoringRules::Status ScoringRules::wideOpenDistance(
+        const DataPoints &data,
+        const Lane &lane,
+        double &distance)
+{
+    if (data.isEmpty()) return NoData;
+
+    // Find exit point
+    const DataPoint dp0 = Kinematics::interpolateT(data, 0);
+    if (dp0.z < lane.bottom) return SetExit;
+
+    // Find where we cross the bottom
+    DataPoint dpBottom;
+    if (!windowBottom(data, lane.bottom, dpBottom)) return IncompleteData;
+
+    distance = laneDistance(lane, dpBottom.lat, dpBottom.lon);
+    return Scored;
+}
+
+ScoringRules::Status ScoringRules::wideOpenSpeed(
+        const DataPoints &data,
+        const Lane &lane,
+        DataPoint &dpFinish,
+        bool &hasFinish)
+{
+    hasFinish = false;
+
+    if (data.isEmpty()) return NoData;
+
+    // Find exit point
+    const DataPoint dp0 = Kinematics::interpolateT(data, 0);
+    if (dp0.z < lane.bottom) return SetExit;
+
+    // Get distance from exit point to reference
+    double exitDist;
+    Geodesic::WGS84().Inverse(lane.endLatitude, lane.endLongitude, dp0.lat, dp0.lon, exitDist);
+    if (exitDist > lane.laneLength * 10) return SetReference;
+
+    // Find where we cross the bottom
+    DataPoint dpBottom;
+    if (!windowBottom(data, lane.bottom, dpBottom)) return IncompleteData;
+
+    // Find where we cross the end of the lane
+    double startLat, startLon;
+    laneStart(lane, startLat, startLon);
+
+    const int start = Kinematics::findIndexBelowT(data, 0) + 1;
+    double d1, t;
+    int i;
+
+    for (i = start; i < data.size(); ++i)
+    {
+        const DataPoint &dp2 = data[i];
+        const double d2 = projectedDistance(lane, startLat, startLon, dp2.lat, dp2.lon);
+
+        if (i > start && d1 < lane.laneLength && d2 >= lane.laneLength)
+        {
+            const DataPoint &dp1 = data[i - 1];
+            t = dp1.t + (dp2.t - dp1.t) / (d2 - d1) * (lane.laneLength - d1);
+            break;
+        }
+
+        d1 = d2;
+    }
+
+    if (i >= data.size()) return DidNotFinish;
+
+    dpFinish = Kinematics::interpolateT(data, t);
+    hasFinish = true;
+
+    return (dpFinish.t <= dpBottom.t) ? Scored : DidNotFinish;
+}
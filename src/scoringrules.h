@@ -0,0 +1,93 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef SCORINGRULES_H
+#define SCORINGRULES_H
+
+#include <QVector>
+
+#include "datapoint.h"
+
+// Competition rules without any dependence on MainWindow or widgets, so
+// they can be shared by the scoring views and headless tools
+
+namespace ScoringRules
+{
+    typedef QVector< DataPoint > DataPoints;
+
+    // Horizontal distance, geodesic when both points have positions
+    double distance(const DataPoint &dp1, const DataPoint &dp2);
+
+    // Interpolated crossings of the window during the descent after exit,
+    // searching back from the end of the track
+    bool windowBounds(const DataPoints &data, double windowTop,
+                      double windowBottom, DataPoint &dpBottom,
+                      DataPoint &dpTop);
+    bool windowBottom(const DataPoints &data, double windowBottom,
+                      DataPoint &dpBottom);
+
+    // PPC results between window crossings
+    double ppcTime(const DataPoint &dpTop, const DataPoint &dpBottom);
+    double ppcDistance(const DataPoint &dpTop, const DataPoint &dpBottom);
+    double ppcSpeed(const DataPoint &dpTop, const DataPoint &dpBottom);
+
+    // Average vertical speed through the window
+    double speed(double windowTop, double windowBottom,
+                 const DataPoint &dpTop, const DataPoint &dpBottom);
+
+    // Wide Open lane, extending laneLength from the end point back along
+    // bearing
+    typedef struct {
+        double endLatitude;
+        double endLongitude;
+        double bearing;
+        double bottom;
+        double laneWidth;
+        double laneLength;
+    } Lane;
+
+    typedef enum {
+        Scored,
+        NoData,
+        SetExit,
+        SetReference,
+        IncompleteData,
+        DidNotFinish
+    } Status;
+
+    void laneStart(const Lane &lane, double &lat, double &lon);
+
+    // Distance along the lane from its start to the projection of a point
+    double laneDistance(const Lane &lane, double lat, double lon);
+
+    // Distance along the lane where the bottom is crossed
+    Status wideOpenDistance(const DataPoints &data, const Lane &lane,
+                            double &distance);
+
+    // Time at which the end of the lane is crossed. hasFinish is set
+    // whenever the end is reached, even if it is after the bottom.
+    Status wideOpenSpeed(const DataPoints &data, const Lane &lane,
+                         DataPoint &dpFinish, bool &hasFinish);
+}
+
+#endif // SCORINGRULES_H
@@ -27,6 +27,7 @@
 #include "mainwindow.h"
 #include "performanceform.h"
 #include "ppcform.h"
+#include "profiler.h"
 #include "scoringmethod.h"
 #include "speedform.h"
 #include "wideopendistanceform.h"
@@ -94,6 +95,8 @@ void ScoringView::setMainWindow(
 
 void ScoringView::updateView()
 {
+    ProfileScope scope("ScoringView::updateView");
+
     // Update forms
     switch (mMainWindow->scoringMode())
     {
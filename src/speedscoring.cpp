@@ -24,6 +24,26 @@
 #include "speedscoring.h"
 
 #include "mainwindow.h"
+#include "scoringrules.h"
+#include "trajectory.h"
+
+namespace
+{
+
+class SpeedEvaluator : public WindowEvaluator
+{
+public:
+    SpeedEvaluator(double windowTop, double windowBottom):
+        WindowEvaluator(windowTop, windowBottom) {}
+
+protected:
+    double score(const Crossing &top, const Crossing &bottom) const
+    {
+        return (windowTop() - windowBottom()) / (bottom.t - top.t);
+    }
+};
+
+} // namespace
 
 SpeedScoring::SpeedScoring(
         MainWindow *mainWindow):
@@ -50,12 +70,17 @@ double SpeedScoring::score(
     DataPoint dpBottom, dpTop;
     if (getWindowBounds(result, dpBottom, dpTop))
     {
-        return (mWindowTop - mWindowBottom) / (dpBottom.t - dpTop.t);
+        return ScoringRules::speed(mWindowTop, mWindowBottom, dpTop, dpBottom);
     }
 
     return 0;
 }
 
+FitnessEvaluator *SpeedScoring::createEvaluator() const
+{
+    return new SpeedEvaluator(mWindowTop, mWindowBottom);
+}
+
 QString SpeedScoring::scoreAsText(
         double score)
 {
@@ -98,7 +123,7 @@ void SpeedScoring::prepareDataPlot(
         yElev << plot->yValue(DataPlot::Elevation)->value(dpTop, mMainWindow->units())
               << plot->yValue(DataPlot::Elevation)->value(dpTop, mMainWindow->units());
 
-        QCPGraph *graph = plot->addGraph(
+        QCPGraph *graph = plot->annotationGraph(
                     plot->axisRect()->axis(QCPAxis::atBottom),
                     plot->yValue(DataPlot::Elevation)->axis());
         graph->setData(xElev, yElev);
@@ -108,13 +133,13 @@ void SpeedScoring::prepareDataPlot(
         yElev << plot->yValue(DataPlot::Elevation)->value(dpBottom, mMainWindow->units())
               << plot->yValue(DataPlot::Elevation)->value(dpBottom, mMainWindow->units());
 
-        graph = plot->addGraph(
+        graph = plot->annotationGraph(
                     plot->axisRect()->axis(QCPAxis::atBottom),
                     plot->yValue(DataPlot::Elevation)->axis());
         graph->setData(xElev, yElev);
         graph->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
 
-        QCPItemRect *rect = new QCPItemRect(plot);
+        QCPItemRect *rect = plot->annotationRect();
 
         rect->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
         rect->setBrush(QColor(0, 0, 0, 8));
@@ -129,7 +154,7 @@ void SpeedScoring::prepareDataPlot(
                     (plot->xValue()->value(dpTop, mMainWindow->units()) - xMin) / (xMax - xMin),
                     1.1);
 
-        rect = new QCPItemRect(plot);
+        rect = plot->annotationRect();
 
         rect->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
         rect->setBrush(QColor(0, 0, 0, 8));
@@ -151,50 +176,5 @@ bool SpeedScoring::getWindowBounds(
         DataPoint &dpBottom,
         DataPoint &dpTop)
 {
-    bool foundBottom = false;
-    bool foundTop = false;
-    int bottom, top;
-
-    for (int i = result.size() - 1; i >= 0; --i)
-    {
-        const DataPoint &dp = result[i];
-
-        if (dp.z < mWindowBottom)
-        {
-            bottom = i;
-            foundBottom = true;
-        }
-
-        if (dp.z < mWindowTop)
-        {
-            top = i;
-            foundTop = false;
-        }
-
-        if (dp.z > mWindowTop)
-        {
-            foundTop = true;
-        }
-
-        if (dp.t < 0) break;
-    }
-
-    if (foundBottom && foundTop)
-    {
-        // Calculate bottom of window
-        const DataPoint &dp1 = result[bottom - 1];
-        const DataPoint &dp2 = result[bottom];
-        dpBottom = DataPoint::interpolate(dp1, dp2, (mWindowBottom - dp1.z) / (dp2.z - dp1.z));
-
-        // Calculate top of window
-        const DataPoint &dp3 = result[top - 1];
-        const DataPoint &dp4 = result[top];
-        dpTop = DataPoint::interpolate(dp3, dp4, (mWindowTop - dp3.z) / (dp4.z - dp3.z));
-
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    return ScoringRules::windowBounds(result, mWindowTop, mWindowBottom, dpBottom, dpTop);
 }
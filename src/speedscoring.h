@@ -40,6 +40,8 @@ public:
     double score(const MainWindow::DataPoints &result);
     QString scoreAsText(double score);
 
+    FitnessEvaluator *createEvaluator() const;
+
     void prepareDataPlot(DataPlot *plot);
 
     bool getWindowBounds(const MainWindow::DataPoints &result,
@@ -0,0 +1,168 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "track.h"
+
+#include <QFile>
+
+#include "profiler.h"
+#include "trackparser.h"
+
+namespace
+{
+
+Kinematics::Parameters defaultParameters()
+{
+    Kinematics::Parameters params;
+
+    params.exit = 0;
+    params.ground = 0;
+    params.windE = 0;
+    params.windN = 0;
+    params.course = 0;
+    params.mass = 70;
+    params.planformArea = 2;
+    params.halfWidth = 2;
+
+    return params;
+}
+
+} // namespace
+
+Track::Track():
+    mParameters(defaultParameters())
+{
+
+}
+
+Track::Track(
+        const DataPoints &data):
+    mData(data),
+    mParameters(defaultParameters())
+{
+
+}
+
+bool Track::load(
+        const QString &fileName)
+{
+    ProfileScope scope("Track::load");
+
+    mData.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    return TrackParser::parse(&file, mData);
+}
+
+void Track::parse(
+        const char *begin,
+        const char *end)
+{
+    mData.clear();
+    TrackParser::parse(begin, end, mData);
+}
+
+void Track::setData(
+        const DataPoints &data)
+{
+    mData = data;
+}
+
+void Track::clear()
+{
+    mData.clear();
+}
+
+void Track::initialize(
+        const Kinematics::Parameters &params)
+{
+    ProfileScope scope("Track::initialize");
+
+    Kinematics::initialize(mData, params);
+    mParameters = params;
+}
+
+int Track::update(
+        const Kinematics::Parameters &params)
+{
+    ProfileScope scope("Track::update");
+
+    const int stages = Kinematics::update(mData, mParameters, params);
+    mParameters = params;
+    return stages;
+}
+
+DataPoint Track::setExit(
+        double t)
+{
+    const DataPoint dp0 = interpolateT(t);
+
+    mParameters.exit = dp0.dateTime.toMSecsSinceEpoch();
+
+    for (int i = 0; i < mData.size(); ++i)
+    {
+        DataPoint &dp = mData[i];
+
+        dp.t -= dp0.t;
+        dp.x -= dp0.x;
+        dp.y -= dp0.y;
+
+        dp.dist2D -= dp0.dist2D;
+        dp.dist3D -= dp0.dist3D;
+    }
+
+    return dp0;
+}
+
+DataPoint Track::interpolateT(
+        double t) const
+{
+    return Kinematics::interpolateT(mData, t);
+}
+
+int Track::findIndexBelowT(
+        double t) const
+{
+    return Kinematics::findIndexBelowT(mData, t);
+}
+
+int Track::findIndexAboveT(
+        double t) const
+{
+    return Kinematics::findIndexAboveT(mData, t);
+}
+
+int Track::findIndexForLanding() const
+{
+    int i = findIndexBelowT(0.0);
+
+    while (++i < mData.size()-1) {
+        const DataPoint &p = mData[i];
+        if (p.velE*p.velE + p.velN*p.velN + p.velD < 1.0)
+            break;
+    }
+
+    return i;
+}
@@ -0,0 +1,87 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACK_H
+#define TRACK_H
+
+#include <QString>
+#include <QVector>
+
+#include "datapoint.h"
+#include "kinematics.h"
+
+// A track owns its samples together with the parameters its derived
+// channels were computed from, so it can be loaded, derived and queried
+// without a MainWindow and on any thread
+
+class Track
+{
+public:
+    typedef QVector< DataPoint > DataPoints;
+
+    Track();
+    explicit Track(const DataPoints &data);
+
+    // Replace the samples. Derived channels are not valid until
+    // initialize() is called.
+    bool load(const QString &fileName);
+    void parse(const char *begin, const char *end);
+    void setData(const DataPoints &data);
+    void clear();
+
+    const DataPoints &data() const { return mData; }
+
+    int size() const { return mData.size(); }
+    bool isEmpty() const { return mData.isEmpty(); }
+
+    const DataPoint &at(int i) const { return mData[i]; }
+    const DataPoint &operator[](int i) const { return mData[i]; }
+    const DataPoint &first() const { return mData.first(); }
+    const DataPoint &last() const { return mData.last(); }
+
+    const Kinematics::Parameters &parameters() const { return mParameters; }
+
+    // Compute all derived channels
+    void initialize(const Kinematics::Parameters &params);
+
+    // Recompute only the channels affected by a change in parameters and
+    // return the stages which were updated
+    int update(const Kinematics::Parameters &params);
+
+    // Move exit to time t by shifting channels rather than recomputing
+    // them, and return the point which was at t
+    DataPoint setExit(double t);
+
+    DataPoint interpolateT(double t) const;
+    int findIndexBelowT(double t) const;
+    int findIndexAboveT(double t) const;
+
+    // First sample after exit where the jumper has come to rest
+    int findIndexForLanding() const;
+
+private:
+    DataPoints             mData;
+    Kinematics::Parameters mParameters;
+};
+
+#endif // TRACK_H
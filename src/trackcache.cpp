@@ -0,0 +1,267 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackcache.h"
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+#include "trackparser.h"
+#include "trackstore.h"
+
+TrackCache::TrackCache(
+        qint64 budget):
+    mBudget(budget),
+    mUsage(0),
+    mClock(0),
+    mHits(0),
+    mMisses(0),
+    mEvictions(0)
+{
+
+}
+
+void TrackCache::setDatabasePath(
+        const QString &databasePath)
+{
+    QMutexLocker locker(&mMutex);
+
+    if (mDatabasePath != databasePath)
+    {
+        mDatabasePath = databasePath;
+
+        // Cached tracks belong to the old logbook
+        mEntries.clear();
+        mUsage = 0;
+    }
+}
+
+void TrackCache::setBudget(
+        qint64 budget)
+{
+    QMutexLocker locker(&mMutex);
+
+    mBudget = budget;
+    evictLocked(QString());
+}
+
+qint64 TrackCache::budget() const
+{
+    QMutexLocker locker(&mMutex);
+    return mBudget;
+}
+
+TrackCache::Track TrackCache::track(
+        const QString &uniqueName)
+{
+    QString databasePath;
+
+    {
+        QMutexLocker locker(&mMutex);
+
+        QHash< QString, Entry >::iterator p = mEntries.find(uniqueName);
+        if (p != mEntries.end())
+        {
+            p->lastUse = ++mClock;
+            ++mHits;
+            return p->data;
+        }
+
+        ++mMisses;
+        databasePath = mDatabasePath;
+    }
+
+    // Parse without holding the lock
+    Track data = load(databasePath, uniqueName);
+    if (data.isNull()) return data;
+
+    QMutexLocker locker(&mMutex);
+
+    // Don't cache tracks from a logbook which has since been changed
+    if (databasePath == mDatabasePath)
+    {
+        insertLocked(uniqueName, data);
+    }
+
+    return data;
+}
+
+void TrackCache::insert(
+        const QString &uniqueName,
+        const TrackData &data)
+{
+    Track track(new TrackData(data));
+
+    QMutexLocker locker(&mMutex);
+    insertLocked(uniqueName, track);
+}
+
+void TrackCache::remove(
+        const QString &uniqueName)
+{
+    QMutexLocker locker(&mMutex);
+
+    QHash< QString, Entry >::iterator p = mEntries.find(uniqueName);
+    if (p != mEntries.end())
+    {
+        mUsage -= p->size;
+        mEntries.erase(p);
+    }
+}
+
+void TrackCache::clear()
+{
+    QMutexLocker locker(&mMutex);
+
+    mEntries.clear();
+    mUsage = 0;
+}
+
+bool TrackCache::contains(
+        const QString &uniqueName) const
+{
+    QMutexLocker locker(&mMutex);
+    return mEntries.contains(uniqueName);
+}
+
+int TrackCache::count() const
+{
+    QMutexLocker locker(&mMutex);
+    return mEntries.size();
+}
+
+qint64 TrackCache::memoryUsage() const
+{
+    QMutexLocker locker(&mMutex);
+    return mUsage;
+}
+
+int TrackCache::hits() const
+{
+    QMutexLocker locker(&mMutex);
+    return mHits;
+}
+
+int TrackCache::misses() const
+{
+    QMutexLocker locker(&mMutex);
+    return mMisses;
+}
+
+int TrackCache::evictions() const
+{
+    QMutexLocker locker(&mMutex);
+    return mEvictions;
+}
+
+void TrackCache::resetStatistics()
+{
+    QMutexLocker locker(&mMutex);
+
+    mHits = 0;
+    mMisses = 0;
+    mEvictions = 0;
+}
+
+TrackCache::Track TrackCache::load(
+        const QString &databasePath,
+        const QString &uniqueName) const
+{
+    // Use binary sidecar if it's up to date
+    TrackData *track = new TrackData(TrackData::Measured);
+    if (TrackStore::read(databasePath, uniqueName, *track))
+    {
+        return Track(track);
+    }
+
+    delete track;
+
+    QFile file(TrackStore::sourcePath(databasePath, uniqueName));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return Track();
+    }
+
+    // Read file data
+    QVector< DataPoint > data;
+    if (!TrackParser::parse(&file, data))
+    {
+        return Track();
+    }
+
+    track = new TrackData(data, TrackData::Measured);
+
+    // Regenerate sidecar in the background
+    QtConcurrent::run(TrackStore::write, databasePath, uniqueName, *track);
+
+    return Track(track);
+}
+
+void TrackCache::insertLocked(
+        const QString &uniqueName,
+        const Track &data)
+{
+    QHash< QString, Entry >::iterator p = mEntries.find(uniqueName);
+    if (p != mEntries.end())
+    {
+        mUsage -= p->size;
+    }
+
+    Entry entry;
+    entry.data = data;
+    entry.size = data->memoryUsage();
+    entry.lastUse = ++mClock;
+
+    mEntries.insert(uniqueName, entry);
+    mUsage += entry.size;
+
+    evictLocked(uniqueName);
+}
+
+void TrackCache::evictLocked(
+        const QString &keep)
+{
+    while (mUsage > mBudget && mEntries.size() > 1)
+    {
+        // Find least recently used track
+        QHash< QString, Entry >::iterator oldest = mEntries.end();
+        for (QHash< QString, Entry >::iterator p = mEntries.begin();
+             p != mEntries.end();
+             ++p)
+        {
+            if (p.key() == keep) continue;
+
+            if (oldest == mEntries.end() || p->lastUse < oldest->lastUse)
+            {
+                oldest = p;
+            }
+        }
+
+        if (oldest == mEntries.end()) break;
+
+        mUsage -= oldest->size;
+        mEntries.erase(oldest);
+        ++mEvictions;
+    }
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKCACHE_H
+#define TRACKCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+#include "trackdata.h"
+
+// Cache of measured track data read from the logbook. Tracks are read on
+// first use, from their binary sidecar when it is current and otherwise by
+// parsing the CSV, in which case the sidecar is rewritten in the background.
+// Tracks are shared as immutable data, so callers can hold on to a track
+// after it has been evicted. When the total size exceeds the budget, the
+// least recently used tracks are dropped.
+
+class TrackCache
+{
+public:
+    typedef QSharedPointer< const TrackData > Track;
+
+    explicit TrackCache(qint64 budget = 256 * 1024 * 1024);
+
+    void setDatabasePath(const QString &databasePath);
+
+    void setBudget(qint64 budget);
+    qint64 budget() const;
+
+    // Returns a null pointer if the track couldn't be read
+    Track track(const QString &uniqueName);
+
+    void insert(const QString &uniqueName, const TrackData &data);
+    void remove(const QString &uniqueName);
+    void clear();
+
+    bool contains(const QString &uniqueName) const;
+
+    int count() const;
+    qint64 memoryUsage() const;
+
+    int hits() const;
+    int misses() const;
+    int evictions() const;
+    void resetStatistics();
+
+private:
+    typedef struct {
+        Track   data;
+        qint64  size;
+        quint64 lastUse;
+    } Entry;
+
+    mutable QMutex          mMutex;
+
+    QString                 mDatabasePath;
+    QHash< QString, Entry > mEntries;
+
+    qint64                  mBudget;
+    qint64                  mUsage;
+    quint64                 mClock;
+
+    int                     mHits;
+    int                     mMisses;
+    int                     mEvictions;
+
+    Track load(const QString &databasePath, const QString &uniqueName) const;
+
+    void insertLocked(const QString &uniqueName, const Track &data);
+    void evictLocked(const QString &keep);
+};
+
+#endif // TRACKCACHE_H
@@ -0,0 +1,271 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackdata.h"
+
+TrackData::TrackData(
+        Contents contents):
+    mContents(contents)
+{
+
+}
+
+TrackData::TrackData(
+        const QVector< DataPoint > &data,
+        Contents contents):
+    mContents(contents)
+{
+    reserve(data.size());
+
+    for (int i = 0; i < data.size(); ++i)
+    {
+        append(data[i]);
+    }
+}
+
+bool TrackData::hasChannel(
+        Channel channel) const
+{
+    return channel < numChannels();
+}
+
+int TrackData::numChannels() const
+{
+    return (mContents == All) ? NumChannels : T;
+}
+
+void TrackData::clear()
+{
+    mMSecs.clear();
+    mHasGeodetic.clear();
+
+    for (int j = 0; j < NumChannels; ++j)
+    {
+        mColumns[j].clear();
+    }
+}
+
+void TrackData::reserve(
+        int size)
+{
+    mMSecs.reserve(size);
+    mHasGeodetic.reserve(size);
+
+    for (int j = 0; j < numChannels(); ++j)
+    {
+        mColumns[j].reserve(size);
+    }
+}
+
+void TrackData::resize(
+        int size)
+{
+    mMSecs.resize(size);
+    mHasGeodetic.resize(size);
+
+    for (int j = 0; j < numChannels(); ++j)
+    {
+        mColumns[j].resize(size);
+    }
+}
+
+void TrackData::append(
+        const DataPoint &dp)
+{
+    mMSecs.append(dp.dateTime.toMSecsSinceEpoch());
+    mHasGeodetic.append(dp.hasGeodetic);
+
+    mColumns[Lat].append(dp.lat);
+    mColumns[Lon].append(dp.lon);
+    mColumns[HMSL].append(dp.hMSL);
+
+    mColumns[VelN].append(dp.velN);
+    mColumns[VelE].append(dp.velE);
+    mColumns[VelD].append(dp.velD);
+
+    mColumns[HAcc].append(dp.hAcc);
+    mColumns[VAcc].append(dp.vAcc);
+    mColumns[SAcc].append(dp.sAcc);
+
+    mColumns[NumSV].append(dp.numSV);
+
+    if (mContents == All)
+    {
+        mColumns[T].append(dp.t);
+        mColumns[X].append(dp.x);
+        mColumns[Y].append(dp.y);
+        mColumns[Z].append(dp.z);
+
+        mColumns[Dist2D].append(dp.dist2D);
+        mColumns[Dist3D].append(dp.dist3D);
+
+        mColumns[Curv].append(dp.curv);
+        mColumns[Accel].append(dp.accel);
+
+        mColumns[Lift].append(dp.lift);
+        mColumns[Drag].append(dp.drag);
+
+        mColumns[Heading].append(dp.heading);
+        mColumns[CAcc].append(dp.cAcc);
+
+        mColumns[Vx].append(dp.vx);
+        mColumns[Vy].append(dp.vy);
+
+        mColumns[Theta].append(dp.theta);
+        mColumns[Omega].append(dp.omega);
+    }
+}
+
+DataPoint TrackData::point(
+        int i) const
+{
+    DataPoint dp;
+
+    dp.dateTime = QDateTime::fromMSecsSinceEpoch(mMSecs[i], Qt::UTC);
+    dp.hasGeodetic = mHasGeodetic[i];
+
+    dp.lat = mColumns[Lat][i];
+    dp.lon = mColumns[Lon][i];
+    dp.hMSL = mColumns[HMSL][i];
+
+    dp.velN = mColumns[VelN][i];
+    dp.velE = mColumns[VelE][i];
+    dp.velD = mColumns[VelD][i];
+
+    dp.hAcc = mColumns[HAcc][i];
+    dp.vAcc = mColumns[VAcc][i];
+    dp.sAcc = mColumns[SAcc][i];
+
+    dp.numSV = (int) mColumns[NumSV][i];
+
+    if (mContents == All)
+    {
+        dp.t = mColumns[T][i];
+        dp.x = mColumns[X][i];
+        dp.y = mColumns[Y][i];
+        dp.z = mColumns[Z][i];
+
+        dp.dist2D = mColumns[Dist2D][i];
+        dp.dist3D = mColumns[Dist3D][i];
+
+        dp.curv = mColumns[Curv][i];
+        dp.accel = mColumns[Accel][i];
+
+        dp.lift = mColumns[Lift][i];
+        dp.drag = mColumns[Drag][i];
+
+        dp.heading = mColumns[Heading][i];
+        dp.cAcc = mColumns[CAcc][i];
+
+        dp.vx = mColumns[Vx][i];
+        dp.vy = mColumns[Vy][i];
+
+        dp.theta = mColumns[Theta][i];
+        dp.omega = mColumns[Omega][i];
+    }
+    else
+    {
+        dp.t = dp.x = dp.y = dp.z = 0;
+        dp.dist2D = dp.dist3D = 0;
+        dp.curv = dp.accel = 0;
+        dp.lift = dp.drag = 0;
+        dp.heading = dp.cAcc = 0;
+        dp.vx = dp.vy = 0;
+        dp.theta = dp.omega = 0;
+    }
+
+    return dp;
+}
+
+void TrackData::setPoint(
+        int i,
+        const DataPoint &dp)
+{
+    mMSecs[i] = dp.dateTime.toMSecsSinceEpoch();
+    mHasGeodetic[i] = dp.hasGeodetic;
+
+    mColumns[Lat][i] = dp.lat;
+    mColumns[Lon][i] = dp.lon;
+    mColumns[HMSL][i] = dp.hMSL;
+
+    mColumns[VelN][i] = dp.velN;
+    mColumns[VelE][i] = dp.velE;
+    mColumns[VelD][i] = dp.velD;
+
+    mColumns[HAcc][i] = dp.hAcc;
+    mColumns[VAcc][i] = dp.vAcc;
+    mColumns[SAcc][i] = dp.sAcc;
+
+    mColumns[NumSV][i] = dp.numSV;
+
+    if (mContents == All)
+    {
+        mColumns[T][i] = dp.t;
+        mColumns[X][i] = dp.x;
+        mColumns[Y][i] = dp.y;
+        mColumns[Z][i] = dp.z;
+
+        mColumns[Dist2D][i] = dp.dist2D;
+        mColumns[Dist3D][i] = dp.dist3D;
+
+        mColumns[Curv][i] = dp.curv;
+        mColumns[Accel][i] = dp.accel;
+
+        mColumns[Lift][i] = dp.lift;
+        mColumns[Drag][i] = dp.drag;
+
+        mColumns[Heading][i] = dp.heading;
+        mColumns[CAcc][i] = dp.cAcc;
+
+        mColumns[Vx][i] = dp.vx;
+        mColumns[Vy][i] = dp.vy;
+
+        mColumns[Theta][i] = dp.theta;
+        mColumns[Omega][i] = dp.omega;
+    }
+}
+
+QVector< DataPoint > TrackData::toDataPoints() const
+{
+    QVector< DataPoint > data(size());
+
+    for (int i = 0; i < size(); ++i)
+    {
+        data[i] = point(i);
+    }
+
+    return data;
+}
+
+qint64 TrackData::memoryUsage() const
+{
+    qint64 usage = mMSecs.capacity() * sizeof(qint64)
+            + mHasGeodetic.capacity() * sizeof(bool);
+
+    for (int j = 0; j < NumChannels; ++j)
+    {
+        usage += mColumns[j].capacity() * sizeof(double);
+    }
+
+    return usage;
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKDATA_H
+#define TRACKDATA_H
+
+#include <QVector>
+
+#include "datapoint.h"
+
+// Column-oriented track storage. Each channel is held in its own contiguous
+// array and timestamps are kept as milliseconds since the epoch (UTC).
+// Derived channels are optional, so tracks which are only kept around for
+// later use can be stored with their measured channels alone.
+
+class TrackData
+{
+public:
+    typedef enum {
+        // Measured channels
+        Lat, Lon, HMSL,
+        VelN, VelE, VelD,
+        HAcc, VAcc, SAcc,
+        NumSV,
+
+        // Derived channels
+        T, X, Y, Z,
+        Dist2D, Dist3D,
+        Curv, Accel,
+        Lift, Drag,
+        Heading, CAcc,
+        Vx, Vy,
+        Theta, Omega,
+
+        NumChannels
+    } Channel;
+
+    typedef enum {
+        Measured,
+        All
+    } Contents;
+
+    TrackData(Contents contents = All);
+    explicit TrackData(const QVector< DataPoint > &data, Contents contents = All);
+
+    Contents contents() const { return mContents; }
+    bool hasChannel(Channel channel) const;
+
+    int size() const { return mMSecs.size(); }
+    bool isEmpty() const { return mMSecs.isEmpty(); }
+
+    void clear();
+    void reserve(int size);
+    void resize(int size);
+
+    void append(const DataPoint &dp);
+
+    DataPoint point(int i) const;
+    void setPoint(int i, const DataPoint &dp);
+
+    QVector< DataPoint > toDataPoints() const;
+
+    // Approximate heap usage in bytes
+    qint64 memoryUsage() const;
+
+    // Direct column access; derived columns are empty for measured-only
+    // tracks
+    const QVector< double > &column(Channel channel) const { return mColumns[channel]; }
+    QVector< double > &column(Channel channel) { return mColumns[channel]; }
+
+    double value(Channel channel, int i) const { return mColumns[channel][i]; }
+
+    const QVector< qint64 > &msecs() const { return mMSecs; }
+    QVector< qint64 > &msecs() { return mMSecs; }
+    qint64 msecs(int i) const { return mMSecs[i]; }
+
+    const QVector< bool > &geodetic() const { return mHasGeodetic; }
+    QVector< bool > &geodetic() { return mHasGeodetic; }
+    bool hasGeodetic(int i) const { return mHasGeodetic[i]; }
+
+private:
+    Contents            mContents;
+
+    QVector< qint64 >   mMSecs;
+    QVector< bool >     mHasGeodetic;
+    QVector< double >   mColumns[NumChannels];
+
+    int numChannels() const;
+};
+
+#endif // TRACKDATA_H
@@ -0,0 +1,167 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackimport.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+#include <QtAlgorithms>
+
+#include "trackparser.h"
+#include "trackstore.h"
+
+bool TrackImport::summarize(
+        const QVector< DataPoint > &data,
+        Summary &summary)
+{
+    if (data.isEmpty()) return false;
+
+    summary.startTime = data.front().dateTime;
+    summary.duration = summary.startTime.msecsTo(data.back().dateTime);
+
+    summary.minLat = 900000000;  summary.maxLat = -900000000;
+    summary.minLon = 1800000000; summary.maxLon = -1800000000;
+
+    QVector< qint64 > dt;
+    dt.reserve(data.size());
+
+    qint64 msPrev = 0;
+    for (int i = 0; i < data.size(); ++i)
+    {
+        const DataPoint &dp = data[i];
+        const qint64 ms = dp.dateTime.toMSecsSinceEpoch();
+
+        if (i > 0)
+        {
+            dt.push_back(ms - msPrev);
+        }
+        msPrev = ms;
+
+        int lat = dp.lat * 10000000;
+        int lon = dp.lon * 10000000;
+
+        if (lat < summary.minLat) summary.minLat = lat;
+        if (lat > summary.maxLat) summary.maxLat = lat;
+        if (lon < summary.minLon) summary.minLon = lon;
+        if (lon > summary.maxLon) summary.maxLon = lon;
+    }
+
+    if (dt.isEmpty())
+    {
+        summary.samplePeriod = 0;
+    }
+    else
+    {
+        qSort(dt);
+        summary.samplePeriod = dt[dt.size() / 2];
+    }
+
+    summary.endTime = data.back().dateTime;
+    summary.endHMSL = data.back().hMSL;
+
+    return true;
+}
+
+TrackImport::Task::Task(
+        const QString &databasePath):
+    mDatabasePath(databasePath)
+{
+
+}
+
+TrackImport::Result TrackImport::Task::operator()(
+        const QString &fileName) const
+{
+    Result result;
+    result.fileName = fileName;
+    result.valid = false;
+    result.stored = false;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        result.error = QObject::tr("Couldn't read file");
+        return result;
+    }
+
+    TrackParser::MappedFile mapped(&file);
+    if (!mapped.isValid())
+    {
+        result.error = QObject::tr("Couldn't read file");
+        return result;
+    }
+
+    // Get hash
+    const QByteArray bytes = QByteArray::fromRawData(mapped.begin(), mapped.size());
+    result.uniqueName = QString(QCryptographicHash::hash(bytes, QCryptographicHash::Md5).toHex());
+
+    // Parse track data
+    QVector< DataPoint > data;
+    TrackParser::parse(mapped.begin(), mapped.end(), data);
+
+    if (!summarize(data, result.summary))
+    {
+        result.error = QObject::tr("File contains no data");
+        return result;
+    }
+
+    result.valid = true;
+
+    // Write the source into the track store unless it is already there
+    QString newName = QString("FlySight/Tracks/%1.csv").arg(result.uniqueName);
+    QString newPath = QDir(mDatabasePath).filePath(newName);
+
+    if (QFileInfo(newPath).exists())
+    {
+        result.stored = true;
+    }
+    else
+    {
+        QDir(mDatabasePath).mkpath("FlySight/Tracks");
+
+        QSaveFile newFile(newPath);
+        if (newFile.open(QIODevice::WriteOnly)
+                && newFile.write(mapped.begin(), mapped.size()) == mapped.size()
+                && newFile.commit())
+        {
+            result.stored = true;
+        }
+        else
+        {
+            result.error = QObject::tr("Couldn't write track file");
+        }
+    }
+
+    // Write binary sidecar for fast reopening
+    if (result.stored)
+    {
+        TrackStore::write(mDatabasePath, result.uniqueName,
+                          TrackData(data, TrackData::Measured));
+    }
+
+    return result;
+}
@@ -0,0 +1,72 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKIMPORT_H
+#define TRACKIMPORT_H
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+#include "datapoint.h"
+
+namespace TrackImport
+{
+    typedef struct {
+        QDateTime startTime;
+        qint64    duration;
+        qint64    samplePeriod;
+        int       minLat, maxLat;
+        int       minLon, maxLon;
+        QDateTime endTime;
+        double    endHMSL;
+    } Summary;
+
+    typedef struct {
+        QString   fileName;
+        QString   uniqueName;
+        QString   error;
+        bool      valid;
+        bool      stored;
+        Summary   summary;
+    } Result;
+
+    bool summarize(const QVector< DataPoint > &data, Summary &summary);
+
+    // Hashes, parses, summarizes and stores one file; safe to run on any
+    // thread because it does not touch the database
+    class Task
+    {
+    public:
+        typedef Result result_type;
+
+        explicit Task(const QString &databasePath);
+
+        Result operator()(const QString &fileName) const;
+
+    private:
+        QString mDatabasePath;
+    };
+}
+
+#endif // TRACKIMPORT_H
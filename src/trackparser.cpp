@@ -0,0 +1,485 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackparser.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+
+#include <stdlib.h>
+#include <string.h>
+
+// Column enumeration
+typedef enum {
+    Time = 0,
+    Lat,
+    Lon,
+    HMSL,
+    VelN,
+    VelE,
+    VelD,
+    HAcc,
+    VAcc,
+    SAcc,
+    NumSV,
+    ColumnCount
+} Columns;
+
+static const int maxFields = 64;
+
+// Powers of ten which are exactly representable as doubles
+static const double powersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const char *nextLine(
+        const char *p,
+        const char *end,
+        const char *&lineEnd)
+{
+    const char *nl = (const char *) memchr(p, '\n', end - p);
+    if (!nl) nl = end;
+
+    // Strip carriage return
+    lineEnd = nl;
+    if (lineEnd > p && lineEnd[-1] == '\r') --lineEnd;
+
+    return (nl < end) ? nl + 1 : end;
+}
+
+static int splitFields(
+        const char *p,
+        const char *end,
+        const char **fieldBegin,
+        const char **fieldEnd)
+{
+    int n = 0;
+
+    while (n < maxFields)
+    {
+        const char *comma = (const char *) memchr(p, ',', end - p);
+
+        fieldBegin[n] = p;
+        if (!comma)
+        {
+            fieldEnd[n++] = end;
+            break;
+        }
+
+        fieldEnd[n++] = comma;
+        p = comma + 1;
+    }
+
+    return n;
+}
+
+static bool readDigits(
+        const char *&p,
+        const char *end,
+        int count,
+        int &value)
+{
+    if (end - p < count) return false;
+
+    int v = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const unsigned d = (unsigned char) p[i] - '0';
+        if (d > 9) return false;
+        v = v * 10 + d;
+    }
+
+    p += count;
+    value = v;
+    return true;
+}
+
+static bool readChar(
+        const char *&p,
+        const char *end,
+        char c)
+{
+    if (p == end || *p != c) return false;
+
+    ++p;
+    return true;
+}
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar
+// From http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+static qint64 daysFromCivil(
+        int y,
+        int m,
+        int d)
+{
+    y -= (m <= 2) ? 1 : 0;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (qint64) era * 146097 + doe - 719468;
+}
+
+bool TrackParser::parseDateTime(
+        const char *begin,
+        const char *end,
+        qint64 &msecs)
+{
+    const char *p = begin;
+    int year, month, day, hour, minute, second;
+
+    // Date and time
+    if (!readDigits(p, end, 4, year) || !readChar(p, end, '-')) return false;
+    if (!readDigits(p, end, 2, month) || !readChar(p, end, '-')) return false;
+    if (!readDigits(p, end, 2, day) || !readChar(p, end, 'T')) return false;
+    if (!readDigits(p, end, 2, hour) || !readChar(p, end, ':')) return false;
+    if (!readDigits(p, end, 2, minute) || !readChar(p, end, ':')) return false;
+    if (!readDigits(p, end, 2, second)) return false;
+
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+    if (hour > 23 || minute > 59 || second > 59) return false;
+
+    // Fractional seconds, rounded to milliseconds as in Qt::ISODate
+    int msec = 0;
+    if (p != end && (*p == '.' || *p == ','))
+    {
+        ++p;
+
+        int fraction = 0, scale = 1, count = 0;
+        while (p != end && (unsigned) ((unsigned char) *p - '0') <= 9)
+        {
+            if (count < 4)
+            {
+                fraction = fraction * 10 + (*p - '0');
+                scale *= 10;
+                ++count;
+            }
+            ++p;
+        }
+
+        if (count == 0) return false;
+        msec = qMin((fraction * 1000 + scale / 2) / scale, 999);
+    }
+
+    // Time zone designator
+    int offset = 0;
+    if (readChar(p, end, 'Z'))
+    {
+        // UTC
+    }
+    else if (p != end && (*p == '+' || *p == '-'))
+    {
+        const int sign = (*p++ == '-') ? -1 : 1;
+
+        int offsetHour, offsetMinute = 0;
+        if (!readDigits(p, end, 2, offsetHour)) return false;
+        readChar(p, end, ':');
+        if (p != end && !readDigits(p, end, 2, offsetMinute)) return false;
+
+        offset = sign * (offsetHour * 60 + offsetMinute);
+    }
+    else
+    {
+        // Local time is left to QDateTime
+        return false;
+    }
+
+    if (p != end) return false;
+
+    const qint64 days = daysFromCivil(year, month, day);
+    msecs = ((days * 24 + hour) * 60 + minute - offset) * 60000
+            + second * 1000 + msec;
+
+    return true;
+}
+
+bool TrackParser::parseDouble(
+        const char *begin,
+        const char *end,
+        double &value)
+{
+    const char *p = begin;
+
+    // Trim whitespace
+    while (p != end && (*p == ' ' || *p == '\t')) ++p;
+    while (end != p && (end[-1] == ' ' || end[-1] == '\t')) --end;
+
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p++ == '-');
+    }
+
+    quint64 mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool valid = false;
+
+    // Integer part
+    while (p != end && (unsigned) ((unsigned char) *p - '0') <= 9)
+    {
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) ++digits;
+        }
+        else
+        {
+            ++exponent;
+        }
+        valid = true;
+        ++p;
+    }
+
+    // Fractional part
+    if (p != end && *p == '.')
+    {
+        ++p;
+        while (p != end && (unsigned) ((unsigned char) *p - '0') <= 9)
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) ++digits;
+                --exponent;
+            }
+            valid = true;
+            ++p;
+        }
+    }
+
+    if (!valid) return false;
+
+    // Exponent
+    if (p != end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+
+        bool negativeExponent = false;
+        if (p != end && (*p == '-' || *p == '+'))
+        {
+            negativeExponent = (*p++ == '-');
+        }
+
+        int e = 0;
+        bool validExponent = false;
+        while (p != end && (unsigned) ((unsigned char) *p - '0') <= 9)
+        {
+            if (e < 10000) e = e * 10 + (*p - '0');
+            validExponent = true;
+            ++p;
+        }
+
+        if (!validExponent) return false;
+        exponent += negativeExponent ? -e : e;
+    }
+
+    if (p != end) return false;
+
+    if (mantissa < ((quint64) 1 << 53) && exponent >= -22 && exponent <= 22)
+    {
+        // Both operands are exact, so the result is correctly rounded
+        const double m = (double) mantissa;
+        value = (exponent < 0) ? m / powersOfTen[-exponent] : m * powersOfTen[exponent];
+        if (negative) value = -value;
+    }
+    else
+    {
+        // Fall back on the C library for unusual input
+        const QByteArray bytes(begin, end - begin);
+        value = strtod(bytes.constData(), 0);
+    }
+
+    return true;
+}
+
+static double fieldToDouble(
+        const char *begin,
+        const char *end)
+{
+    double value;
+    if (TrackParser::parseDouble(begin, end, value)) return value;
+    else                                             return 0;
+}
+
+TrackParser::MappedFile::MappedFile(
+        QFile *file):
+    mFile(file),
+    mMap(0),
+    mBegin(0),
+    mSize(0),
+    mValid(false)
+{
+    const qint64 size = file->size();
+
+    if (size > 0)
+    {
+        // Map the file directly into memory
+        mMap = file->map(0, size);
+        if (mMap)
+        {
+            mBegin = (const char *) mMap;
+            mSize = size;
+            mValid = true;
+            return;
+        }
+    }
+
+    // Fall back on a buffered read
+    if (file->seek(0))
+    {
+        mBuffer = file->readAll();
+        mBegin = mBuffer.constData();
+        mSize = mBuffer.size();
+        mValid = true;
+    }
+}
+
+TrackParser::MappedFile::~MappedFile()
+{
+    if (mMap) mFile->unmap(mMap);
+}
+
+bool TrackParser::parse(
+        QFile *file,
+        QVector< DataPoint > &data)
+{
+    MappedFile mapped(file);
+    if (!mapped.isValid()) return false;
+
+    parse(mapped.begin(), mapped.end(), data);
+    return true;
+}
+
+void TrackParser::parse(
+        const char *begin,
+        const char *end,
+        QVector< DataPoint > &data)
+{
+    const char *fieldBegin[maxFields];
+    const char *fieldEnd[maxFields];
+
+    const char *p = begin;
+    const char *lineEnd;
+
+    // Read column labels
+    int colMap[ColumnCount];
+    for (int c = 0; c < ColumnCount; ++c)
+    {
+        colMap[c] = -1;
+    }
+
+    if (p < end)
+    {
+        const char *lineBegin = p;
+        p = nextLine(p, end, lineEnd);
+
+        const int n = splitFields(lineBegin, lineEnd, fieldBegin, fieldEnd);
+        for (int i = 0; i < n; ++i)
+        {
+            const QByteArray s = QByteArray::fromRawData(
+                        fieldBegin[i], fieldEnd[i] - fieldBegin[i]);
+
+            if (s == "time")    colMap[Time]    = i;
+            if (s == "lat")     colMap[Lat]     = i;
+            if (s == "lon")     colMap[Lon]     = i;
+            if (s == "hMSL")    colMap[HMSL]    = i;
+            if (s == "velN")    colMap[VelN]    = i;
+            if (s == "velE")    colMap[VelE]    = i;
+            if (s == "velD")    colMap[VelD]    = i;
+            if (s == "hAcc")    colMap[HAcc]    = i;
+            if (s == "vAcc")    colMap[VAcc]    = i;
+            if (s == "sAcc")    colMap[SAcc]    = i;
+            if (s == "numSV")   colMap[NumSV]   = i;
+        }
+    }
+
+    // Skip next row
+    if (p < end) p = nextLine(p, end, lineEnd);
+
+    data.clear();
+
+    // Estimate row count from the first data row
+    if (p < end)
+    {
+        const qint64 rowSize = nextLine(p, end, lineEnd) - p;
+        data.reserve((end - p) / rowSize + 1);
+    }
+
+    double value[ColumnCount];
+
+    while (p < end)
+    {
+        const char *lineBegin = p;
+        p = nextLine(p, end, lineEnd);
+
+        // Skip blank lines
+        if (lineEnd == lineBegin) continue;
+
+        const int n = splitFields(lineBegin, lineEnd, fieldBegin, fieldEnd);
+
+        for (int c = Lat; c < ColumnCount; ++c)
+        {
+            const int i = colMap[c];
+            value[c] = (i >= 0 && i < n) ? fieldToDouble(fieldBegin[i], fieldEnd[i]) : 0;
+        }
+
+        DataPoint pt;
+
+        const int i = colMap[Time];
+        if (i >= 0 && i < n)
+        {
+            qint64 msecs;
+            if (parseDateTime(fieldBegin[i], fieldEnd[i], msecs))
+            {
+                pt.dateTime = QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC);
+            }
+            else
+            {
+                pt.dateTime = QDateTime::fromString(
+                            QString::fromLatin1(fieldBegin[i], fieldEnd[i] - fieldBegin[i]),
+                            Qt::ISODate);
+            }
+        }
+
+        pt.hasGeodetic = true;
+
+        pt.lat   = value[Lat];
+        pt.lon   = value[Lon];
+        pt.hMSL  = value[HMSL];
+
+        pt.velN  = value[VelN];
+        pt.velE  = value[VelE];
+        pt.velD  = value[VelD];
+
+        pt.hAcc  = value[HAcc];
+        pt.vAcc  = value[VAcc];
+        pt.sAcc  = value[SAcc];
+
+        pt.numSV = value[NumSV];
+
+        data.append(pt);
+    }
+}
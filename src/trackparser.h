@@ -0,0 +1,68 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKPARSER_H
+#define TRACKPARSER_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "datapoint.h"
+
+class QFile;
+
+namespace TrackParser
+{
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(QFile *file);
+        ~MappedFile();
+
+        bool isValid() const { return mValid; }
+
+        const char *begin() const { return mBegin; }
+        const char *end() const { return mBegin + mSize; }
+        qint64 size() const { return mSize; }
+
+    private:
+        QFile      *mFile;
+        uchar      *mMap;
+        QByteArray  mBuffer;
+
+        const char *mBegin;
+        qint64      mSize;
+        bool        mValid;
+
+        MappedFile(const MappedFile &);
+        MappedFile &operator=(const MappedFile &);
+    };
+
+    bool parse(QFile *file, QVector< DataPoint > &data);
+    void parse(const char *begin, const char *end, QVector< DataPoint > &data);
+
+    bool parseDateTime(const char *begin, const char *end, qint64 &msecs);
+    bool parseDouble(const char *begin, const char *end, double &value);
+}
+
+#endif // TRACKPARSER_H
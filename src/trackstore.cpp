@@ -0,0 +1,217 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trackstore.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <limits.h>
+#include <string.h>
+
+namespace
+{
+
+const char   MAGIC[8]   = { 'F', 'S', 'V', 'T', 'R', 'A', 'C', 'K' };
+const quint32 VERSION    = 2;           // Layout of the file itself
+const quint32 SCHEMA     = 1;           // Parser and measured channel set
+const quint32 BYTE_ORDER = 0x01020304;
+
+typedef struct {
+    char    magic[8];
+    quint32 version;
+    quint32 schema;
+    quint32 byteOrder;
+    quint32 numChannels;
+    qint64  count;
+    qint64  sourceSize;
+    qint64  sourceModified;             // ms since epoch
+} Header;
+
+qint64 paddedSize(
+        qint64 size)
+{
+    return (size + 7) & ~(qint64) 7;
+}
+
+qint64 fileSize(
+        qint64 count)
+{
+    return sizeof(Header)
+            + count * sizeof(qint64)
+            + paddedSize(count)
+            + count * sizeof(double) * TrackData::T;
+}
+
+} // namespace
+
+QString TrackStore::sourcePath(
+        const QString &databasePath,
+        const QString &uniqueName)
+{
+    QString newName = QString("FlySight/Tracks/%1.csv").arg(uniqueName);
+    return QDir(databasePath).filePath(newName);
+}
+
+QString TrackStore::sidecarPath(
+        const QString &databasePath,
+        const QString &uniqueName)
+{
+    QString newName = QString("FlySight/Tracks/%1.bin").arg(uniqueName);
+    return QDir(databasePath).filePath(newName);
+}
+
+bool TrackStore::read(
+        const QString &databasePath,
+        const QString &uniqueName,
+        TrackData &data)
+{
+    const QFileInfo source(sourcePath(databasePath, uniqueName));
+    if (!source.exists()) return false;
+
+    QFile file(sidecarPath(databasePath, uniqueName));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const qint64 size = file.size();
+    if (size < (qint64) sizeof(Header)) return false;
+
+    const uchar *map = file.map(0, size);
+    if (!map) return false;
+
+    // Check header
+    Header header;
+    memcpy(&header, map, sizeof(Header));
+
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+            || header.version != VERSION
+            || header.schema != SCHEMA
+            || header.byteOrder != BYTE_ORDER
+            || header.numChannels != (quint32) TrackData::T
+            || header.count < 0
+            || header.count > INT_MAX
+            || header.sourceSize != source.size()
+            || header.sourceModified != source.lastModified().toMSecsSinceEpoch()
+            || size != fileSize(header.count))
+    {
+        file.unmap((uchar *) map);
+        return false;
+    }
+
+    // Copy columns
+    const int count = (int) header.count;
+    const uchar *p = map + sizeof(Header);
+
+    data = TrackData(TrackData::Measured);
+    data.resize(count);
+
+    memcpy(data.msecs().data(), p, count * sizeof(qint64));
+    p += count * sizeof(qint64);
+
+    QVector< bool > &geodetic = data.geodetic();
+    for (int i = 0; i < count; ++i)
+    {
+        geodetic[i] = (p[i] != 0);
+    }
+    p += paddedSize(count);
+
+    for (int j = 0; j < TrackData::T; ++j)
+    {
+        memcpy(data.column((TrackData::Channel) j).data(), p, count * sizeof(double));
+        p += count * sizeof(double);
+    }
+
+    file.unmap((uchar *) map);
+    return true;
+}
+
+bool TrackStore::write(
+        const QString &databasePath,
+        const QString &uniqueName,
+        const TrackData &data)
+{
+    const QFileInfo source(sourcePath(databasePath, uniqueName));
+    if (!source.exists()) return false;
+
+    Header header;
+    memset(&header, 0, sizeof(Header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+
+    header.version = VERSION;
+    header.schema = SCHEMA;
+    header.byteOrder = BYTE_ORDER;
+    header.numChannels = TrackData::T;
+    header.count = data.size();
+    header.sourceSize = source.size();
+    header.sourceModified = source.lastModified().toMSecsSinceEpoch();
+
+    // Build geodetic flags
+    const int count = data.size();
+    QByteArray geodetic(paddedSize(count), 0);
+    for (int i = 0; i < count; ++i)
+    {
+        geodetic[i] = data.hasGeodetic(i) ? 1 : 0;
+    }
+
+    QSaveFile file(sidecarPath(databasePath, uniqueName));
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    file.write((const char *) &header, sizeof(Header));
+    file.write((const char *) data.msecs().constData(), count * sizeof(qint64));
+    file.write(geodetic);
+
+    for (int j = 0; j < TrackData::T; ++j)
+    {
+        const QVector< double > &column = data.column((TrackData::Channel) j);
+        file.write((const char *) column.constData(), count * sizeof(double));
+    }
+
+    // The track may have been deleted while this was running
+    if (!QFile::exists(source.filePath()))
+    {
+        file.cancelWriting();
+        return false;
+    }
+
+    // Nothing is replaced unless every write succeeded
+    if (!file.commit()) return false;
+
+    // Deleting a track removes the source before the sidecar, so either
+    // this check or the deletion catches a sidecar committed meanwhile
+    if (!QFile::exists(source.filePath()))
+    {
+        QFile::remove(file.fileName());
+        return false;
+    }
+
+    return true;
+}
+
+void TrackStore::remove(
+        const QString &databasePath,
+        const QString &uniqueName)
+{
+    QFile::remove(sidecarPath(databasePath, uniqueName));
+}
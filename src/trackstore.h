@@ -0,0 +1,56 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRACKSTORE_H
+#define TRACKSTORE_H
+
+#include <QString>
+
+#include "trackdata.h"
+
+// Binary sidecar files kept next to each track in the logbook. A sidecar
+// holds the measured columns of a track so it can be reopened without
+// parsing the CSV. The layout is
+//
+//   Header
+//   qint64 msecs[count]
+//   quint8 hasGeodetic[count], padded to a multiple of 8 bytes
+//   double column[count] for each measured channel, in TrackData order
+//
+// in native byte order. A sidecar is only used if its format, schema,
+// byte order, source size and source modification time all match.
+
+namespace TrackStore
+{
+    QString sourcePath(const QString &databasePath, const QString &uniqueName);
+    QString sidecarPath(const QString &databasePath, const QString &uniqueName);
+
+    bool read(const QString &databasePath, const QString &uniqueName,
+              TrackData &data);
+    bool write(const QString &databasePath, const QString &uniqueName,
+               const TrackData &data);
+
+    void remove(const QString &databasePath, const QString &uniqueName);
+}
+
+#endif // TRACKSTORE_H
@@ -0,0 +1,113 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#include "trajectory.h"
+
+Trajectory::Trajectory():
+    mSize(0)
+{
+
+}
+
+void Trajectory::start(
+        const DataPoint &dp0,
+        double theta,
+        double v,
+        int capacity)
+{
+    mOrigin = dp0;
+
+    if (mStates.size() < capacity)
+    {
+        mStates.resize(capacity);
+    }
+
+    State &state = mStates[0];
+
+    state.t = dp0.t;
+    state.theta = theta;
+    state.v = v;
+    state.x = 0;
+    state.y = dp0.hMSL;
+    state.dist2D = dp0.dist2D;
+    state.dist3D = dp0.dist3D;
+    state.lift = dp0.lift;
+    state.drag = dp0.drag;
+
+    mSize = 1;
+}
+
+void Trajectory::append(
+        const State &state)
+{
+    if (mSize == mStates.size())
+    {
+        mStates.resize(2 * mSize + 1);
+    }
+
+    mStates[mSize++] = state;
+}
+
+DataPoint Trajectory::point(
+        int i) const
+{
+    if (i == 0) return mOrigin;
+
+    const State &state = mStates[i];
+
+    DataPoint pt;
+
+    pt.hasGeodetic = false;
+
+    pt.hMSL  = state.y;
+
+    pt.vx    = 0;
+    pt.vy    = state.v * cos(state.theta);
+    pt.velD  = -state.v * sin(state.theta);
+
+    pt.t = t(i);
+    pt.x = x(i);
+    pt.y = y(i);
+    pt.z = z(i);
+
+    pt.dist2D = state.dist2D;
+    pt.dist3D = state.dist3D;
+
+    pt.lift = state.lift;
+    pt.drag = state.drag;
+
+    return pt;
+}
+
+QVector< DataPoint > Trajectory::toDataPoints() const
+{
+    QVector< DataPoint > result;
+    result.reserve(mSize);
+
+    for (int i = 0; i < mSize; ++i)
+    {
+        result.append(point(i));
+    }
+
+    return result;
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+**                                                                        **
+**  FlySight Viewer                                                       **
+**  Copyright 2018 Michael Cooper                                         **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>. **
+**                                                                        **
+****************************************************************************
+**  Contact: Michael Cooper                                               **
+**  Website: http://flysight.ca/                                          **
+****************************************************************************/
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <QVector>
+
+#include "datapoint.h"
+
+// Simulated trajectory in the vertical plane. Starting a new trajectory
+// keeps the existing storage, so a buffer which is reused for many
+// simulations stops allocating once it has grown to the longest one.
+// Data points are only built on request.
+
+class Trajectory
+{
+public:
+    typedef struct {
+        double t;           // Time from exit (s)
+        double theta;       // Flight path angle (rad)
+        double v;           // Total speed (m/s)
+        double x;           // Horizontal distance (m)
+        double y;           // Altitude above sea level (m)
+        double dist2D;
+        double dist3D;
+        double lift;        // Lift coefficient
+        double drag;        // Drag coefficient
+    } State;
+
+    Trajectory();
+
+    // Clear the trajectory and add the initial state
+    void start(const DataPoint &dp0, double theta, double v, int capacity);
+
+    void append(const State &state);
+
+    int size() const { return mSize; }
+    bool isEmpty() const { return mSize == 0; }
+
+    const State &at(int i) const { return mStates[i]; }
+    const State &last() const { return mStates[mSize - 1]; }
+
+    const DataPoint &origin() const { return mOrigin; }
+
+    // Fields of point(i), without building the data point
+    double t(int i) const { return mStates[i].t; }
+    double x(int i) const { return i == 0 ? mOrigin.x : mStates[i].x; }
+    double y(int i) const { return i == 0 ? mOrigin.y : 0; }
+    double z(int i) const { return i == 0 ? mOrigin.z : mStates[i].y + mOrigin.z - mOrigin.hMSL; }
+    double hMSL(int i) const { return mStates[i].y; }
+
+    DataPoint point(int i) const;
+    QVector< DataPoint > toDataPoints() const;
+
+private:
+    DataPoint           mOrigin;
+    QVector< State >    mStates;
+    int                 mSize;
+};
+
+Q_DECLARE_TYPEINFO(Trajectory::State, Q_PRIMITIVE_TYPE);
+
+#endif // TRAJECTORY_H
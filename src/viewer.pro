@@ -0,0 +1,129 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2013-02-02T15:04:16
+#
+#-------------------------------------------------
+
+QT       += core gui printsupport webkitwidgets sql concurrent
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x000000
+
+TARGET = FlySightViewer
+TEMPLATE = app
+
+SOURCES += main.cpp \
+    mainwindow.cpp \
+    dataplot.cpp \
+    dataview.cpp \
+    waypoint.cpp \
+    configdialog.cpp \
+    mapview.cpp \
+    common.cpp \
+    videoview.cpp \
+    windplot.cpp \
+    liftdragplot.cpp \
+    scoringview.cpp \
+    orthoview.cpp \
+    playbackview.cpp \
+    ppcform.cpp \
+    speedform.cpp \
+    scoringmethod.cpp \
+    ppcscoring.cpp \
+    speedscoring.cpp \
+    wideopenspeedform.cpp \
+    wideopendistanceform.cpp \
+    wideopendistancescoring.cpp \
+    wideopenspeedscoring.cpp \
+    importworker.cpp \
+    logbookview.cpp \
+    performancescoring.cpp \
+    performanceform.cpp \
+    flareform.cpp \
+    flarescoring.cpp \
+    ppcupload.cpp \
+    performanceview.cpp \
+    refreshscheduler.cpp \
+    QCustomPlot/qcustomplot.cpp
+
+HEADERS  += mainwindow.h \
+    dataplot.h \
+    dataview.h \
+    waypoint.h \
+    plotvalue.h \
+    configdialog.h \
+    mapview.h \
+    videoview.h \
+    windplot.h \
+    liftdragplot.h \
+    scoringview.h \
+    orthoview.h \
+    playbackview.h \
+    ppcform.h \
+    speedform.h \
+    scoringmethod.h \
+    ppcscoring.h \
+    speedscoring.h \
+    performancescoring.h \
+    performanceform.h \
+    wideopenspeedform.h \
+    wideopendistanceform.h \
+    wideopendistancescoring.h \
+    wideopenspeedscoring.h \
+    importworker.h \
+    logbookview.h \
+    flareform.h \
+    flarescoring.h \
+    ppcupload.h \
+    performanceview.h \
+    refreshscheduler.h \
+    QCustomPlot/qcustomplot.h
+
+FORMS    += mainwindow.ui \
+    configdialog.ui \
+    videoview.ui \
+    scoringview.ui \
+    playbackview.ui \
+    ppcform.ui \
+    getuserdialog.ui \
+    speedform.ui \
+    performanceform.ui \
+    wideopenspeedform.ui \
+    wideopendistanceform.ui \
+    logbookview.ui \
+    flareform.ui
+
+win32 {
+    RC_ICONS = FlySightViewer.ico
+}
+else {
+    ICON = FlySightViewer.icns
+}
+
+RESOURCES += \
+    resource.qrc
+
+include(core/core.pri)
+
+INCLUDEPATH += ../include
+INCLUDEPATH += ../include/wwWidgets
+
+win32 {
+    LIBS += -L../lib
+    LIBS += -lVLCQtCore -l VLCQtQml -lVLCQtWidgets
+    LIBS += -lwwwidgets4
+}
+else:macx {
+    QMAKE_LFLAGS += -F../frameworks
+    LIBS         += -framework VLCQtCore
+    LIBS         += -framework VLCQtQml
+    LIBS         += -framework VLCQtWidgets
+    LIBS         += -framework wwwidgets4
+}
+else {
+    LIBS += -L/usr/local/lib
+    LIBS += -lvlc-qt -lvlc-qt-widgets
+    LIBS += -lwwwidgets4
+}
+
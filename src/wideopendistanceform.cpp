@@ -24,16 +24,9 @@
 #include "wideopendistanceform.h"
 #include "ui_wideopendistanceform.h"
 
-#include "GeographicLib/Constants.hpp"
-#include "GeographicLib/Geodesic.hpp"
-
-#include "geographicutil.h"
 #include "mainwindow.h"
 #include "wideopendistancescoring.h"
 
-using namespace GeographicLib;
-using namespace GeographicUtil;
-
 WideOpenDistanceForm::WideOpenDistanceForm(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::WideOpenDistanceForm),
@@ -102,55 +95,31 @@ void WideOpenDistanceForm::updateView()
 
     ui->distanceUnits->setText((mMainWindow->units() == PlotValue::Metric) ? tr("km") : tr("mi"));
 
-    // Find reference point for distance
-    DataPoint dpTop;
-    dpTop.hasGeodetic = true;
-    Geodesic::WGS84().Direct(endLatitude, endLongitude, bearing, laneLength, dpTop.lat, dpTop.lon);
-
-    // Find exit point
-    DataPoint dp0 = mMainWindow->interpolateDataT(0);
-
-    // Find where we cross the bottom
-    DataPoint dpBottom;
-    bool success = method->getWindowBounds(mMainWindow->data(), dpBottom);
+    // Find where we cross the bottom of the lane
+    double distance;
+    ScoringRules::Status status = ScoringRules::wideOpenDistance(mMainWindow->data(), method->lane(), distance);
 
-    if (mMainWindow->dataSize() == 0)
+    if (status == ScoringRules::NoData)
     {
         // Update display
         ui->distanceEdit->setText(tr("no data"));
     }
-    else if (dp0.z < bottom)
+    else if (status == ScoringRules::SetExit)
     {
         // Update display
         ui->distanceEdit->setText(tr("set exit"));
     }
-    else if (!success)
+    else if (status == ScoringRules::IncompleteData)
     {
         // Update display
         ui->distanceEdit->setText(tr("incomplete data"));
     }
     else
     {
-        // Get projected point
-        double lat0, lon0;
-        intercept(dpTop.lat, dpTop.lon, endLatitude, endLongitude, dpBottom.lat, dpBottom.lon, lat0, lon0);
-
-        // Distance from top
-        double topDist;
-        Geodesic::WGS84().Inverse(dpTop.lat, dpTop.lon, lat0, lon0, topDist);
-
-        // Distance from bottom
-        double bottomDist;
-        Geodesic::WGS84().Inverse(endLatitude, endLongitude, lat0, lon0, bottomDist);
-
-        double s12;
-        if (topDist > bottomDist) s12 = topDist;
-        else                      s12 = laneLength - bottomDist;
-
         ui->distanceEdit->setText(QString("%1").arg(
                                       (mMainWindow->units() == PlotValue::Metric) ?
-                                          s12 / 1000 :
-                                          s12 * METERS_TO_FEET / 5280,
+                                          distance / 1000 :
+                                          distance * METERS_TO_FEET / 5280,
                                       0, 'f', 3));
     }
 }
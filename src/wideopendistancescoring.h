@@ -25,6 +25,7 @@
 #define WIDEOPENDISTANCESCORING_H
 
 #include "scoringmethod.h"
+#include "scoringrules.h"
 
 class MainWindow;
 
@@ -53,6 +54,8 @@ public:
     double laneLength(void) const { return mLaneLength; }
     void setLaneLength(double laneLength);
 
+    ScoringRules::Lane lane() const;
+
     void setMapMode(MapMode mode);
 
     void prepareDataPlot(DataPlot *plot);
@@ -24,17 +24,10 @@
 #include "wideopenspeedform.h"
 #include "ui_wideopenspeedform.h"
 
-#include "GeographicLib/Constants.hpp"
-#include "GeographicLib/Geodesic.hpp"
-
-#include "geographicutil.h"
 #include "mainwindow.h"
 #include "plotvalue.h"
 #include "wideopenspeedscoring.h"
 
-using namespace GeographicLib;
-using namespace GeographicUtil;
-
 WideOpenSpeedForm::WideOpenSpeedForm(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::WideOpenSpeedForm),
@@ -101,106 +94,43 @@ void WideOpenSpeedForm::updateView()
     ui->laneWidthEdit->setText(QString("%1").arg(laneWidth * factor, 0, 'f', 0));
     ui->laneLengthEdit->setText(QString("%1").arg(laneLength * factor, 0, 'f', 0));
 
-    // Find reference point for distance
-    DataPoint dpTop;
-    dpTop.hasGeodetic = true;
-    Geodesic::WGS84().Direct(endLatitude, endLongitude, bearing, laneLength, dpTop.lat, dpTop.lon);
-
-    // Find exit point
-    DataPoint dp0 = mMainWindow->interpolateDataT(0);
-
-    // Get distance from exit point to reference
-    double exitDist;
-    Geodesic::WGS84().Inverse(endLatitude, endLongitude, dp0.lat, dp0.lon, exitDist);
-
-    // Find where we cross the bottom
-    DataPoint dpBottom;
-    bool success = method->getWindowBounds(mMainWindow->data(), dpBottom);
+    // Find where we cross the end of the lane
+    DataPoint dpFinish;
+    bool hasFinish;
+    ScoringRules::Status status = ScoringRules::wideOpenSpeed(mMainWindow->data(), method->lane(), dpFinish, hasFinish);
 
-    // Invalidate finish point
+    // Update finish point
     method->invalidateFinish();
+    if (hasFinish) method->setFinishPoint(dpFinish);
 
-    if (mMainWindow->dataSize() == 0)
+    if (status == ScoringRules::NoData)
     {
         // Update display
         ui->speedEdit->setText(tr("no data"));
     }
-    else if (dp0.z < bottom)
+    else if (status == ScoringRules::SetExit)
     {
         // Update display
         ui->speedEdit->setText(tr("set exit"));
     }
-    else if (exitDist > laneLength * 10)
+    else if (status == ScoringRules::SetReference)
     {
         // Update display
         ui->speedEdit->setText(tr("set reference"));
     }
-    else if (!success)
+    else if (status == ScoringRules::IncompleteData)
     {
         // Update display
         ui->speedEdit->setText(tr("incomplete data"));
     }
+    else if (status == ScoringRules::DidNotFinish)
+    {
+        // Update display
+        ui->speedEdit->setText(tr("did not finish"));
+    }
     else
     {
-        // Calculate time
-        int i, start = mMainWindow->findIndexBelowT(0) + 1;
-        double d1, t;
-        DataPoint dp1;
-
-        for (i = start; i < mMainWindow->dataSize(); ++i)
-        {
-            const DataPoint &dp2 = mMainWindow->dataPoint(i);
-
-            // Get projected point
-            double lat0, lon0;
-            intercept(dpTop.lat, dpTop.lon, endLatitude, endLongitude, dp2.lat, dp2.lon, lat0, lon0);
-
-            // Distance from top
-            double topDist;
-            Geodesic::WGS84().Inverse(dpTop.lat, dpTop.lon, lat0, lon0, topDist);
-
-            // Distance from bottom
-            double bottomDist;
-            Geodesic::WGS84().Inverse(endLatitude, endLongitude, lat0, lon0, bottomDist);
-
-            double d2;
-            if (topDist > bottomDist)
-            {
-                d2 = topDist;
-            }
-            else
-            {
-                d2 = laneLength - bottomDist;
-            }
-
-            if (i > start && d1 < laneLength && d2 >= laneLength)
-            {
-                t = dp1.t + (dp2.t - dp1.t) / (d2 - d1) * (laneLength - d1);
-                break;
-            }
-
-            d1 = d2;
-            dp1 = dp2;
-        }
-
-        if (i < mMainWindow->dataSize())
-        {
-            DataPoint dp = mMainWindow->interpolateDataT(t);
-            method->setFinishPoint(dp);
-
-            if (dp.t <= dpBottom.t)
-            {
-                ui->speedEdit->setText(dp.dateTime.toUTC().toString("hh:mm:ss.zzz"));
-            }
-            else
-            {
-                ui->speedEdit->setText(tr("did not finish"));
-            }
-        }
-        else
-        {
-            ui->speedEdit->setText(tr("did not finish"));
-        }
+        ui->speedEdit->setText(dpFinish.dateTime.toUTC().toString("hh:mm:ss.zzz"));
     }
 }
 
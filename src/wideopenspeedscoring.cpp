@@ -121,6 +121,20 @@ void WideOpenSpeedScoring::setLaneLength(
     emit scoringChanged();
 }
 
+ScoringRules::Lane WideOpenSpeedScoring::lane() const
+{
+    ScoringRules::Lane lane;
+
+    lane.endLatitude = mEndLatitude;
+    lane.endLongitude = mEndLongitude;
+    lane.bearing = mBearing;
+    lane.bottom = mBottom;
+    lane.laneWidth = mLaneWidth;
+    lane.laneLength = mLaneLength;
+
+    return lane;
+}
+
 void WideOpenSpeedScoring::setMapMode(
         MapMode mode)
 {
@@ -152,13 +166,13 @@ void WideOpenSpeedScoring::prepareDataPlot(
         yElev << plot->yValue(DataPlot::Elevation)->value(dpBottom, mMainWindow->units())
               << plot->yValue(DataPlot::Elevation)->value(dpBottom, mMainWindow->units());
 
-        QCPGraph *graph = plot->addGraph(
+        QCPGraph *graph = plot->annotationGraph(
                     plot->axisRect()->axis(QCPAxis::atBottom),
                     plot->yValue(DataPlot::Elevation)->axis());
         graph->setData(xElev, yElev);
         graph->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
 
-        QCPItemRect *rect = new QCPItemRect(plot);
+        QCPItemRect *rect = plot->annotationRect();
 
         rect->setPen(QPen(QBrush(Qt::lightGray), mMainWindow->lineThickness(), Qt::DashLine));
         rect->setBrush(QColor(0, 0, 0, 8));
@@ -394,35 +408,7 @@ bool WideOpenSpeedScoring::getWindowBounds(
         const MainWindow::DataPoints &result,
         DataPoint &dpBottom)
 {
-    bool foundBottom = false;
-    int bottom;
-
-    for (int i = result.size() - 1; i >= 0; --i)
-    {
-        const DataPoint &dp = result[i];
-
-        if (dp.z < mBottom)
-        {
-            bottom = i;
-            foundBottom = true;
-        }
-
-        if (dp.t < 0) break;
-    }
-
-    if (foundBottom)
-    {
-        // Calculate bottom of window
-        const DataPoint &dp1 = result[bottom - 1];
-        const DataPoint &dp2 = result[bottom];
-        dpBottom = DataPoint::interpolate(dp1, dp2, (mBottom - dp1.z) / (dp2.z - dp1.z));
-
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    return ScoringRules::windowBottom(result, mBottom, dpBottom);
 }
 
 bool WideOpenSpeedScoring::updateReference(
@@ -27,7 +27,9 @@
 
 #include "common.h"
 #include "windplot.h"
+#include "kinematics.h"
 #include "mainwindow.h"
+#include "profiler.h"
 
 WindPlot::WindPlot(QWidget *parent) :
     QCustomPlot(parent),
@@ -94,6 +96,8 @@ void WindPlot::mouseMoveEvent(
 
 void WindPlot::updatePlot()
 {
+    ProfileScope scope("WindPlot::updatePlot");
+
     clearPlottables();
     clearItems();
 
@@ -302,74 +306,8 @@ void WindPlot::updateWind(
         const int start,
         const int end)
 {
-    // Weighted least-squares circle fit based on this:
-    //   http://www.dtcenter.org/met/users/docs/write_ups/circle_fit.pdf
-
-    double xbar = 0, ybar = 0, N = 0;
-    for (int i = start; i < end; ++i)
-    {
-        const DataPoint &dp = mMainWindow->dataPoint(i);
-
-        const double wi = 1.0;
-
-        const double xi = dp.velE;
-        const double yi = dp.velN;
-
-        xbar += wi * xi;
-        ybar += wi * yi;
-
-        N += wi;
-    }
-
-    xbar /= N;
-    ybar /= N;
-
-    double suu = 0, suv = 0, svv = 0;
-    double suuu = 0, suvv = 0, svuu = 0, svvv = 0;
-    for (int i = start; i < end; ++i)
-    {
-        const DataPoint &dp = mMainWindow->dataPoint(i);
-
-        const double wi = 1.0;
-
-        const double xi = dp.velE;
-        const double yi = dp.velN;
-
-        const double ui = xi - xbar;
-        const double vi = yi - ybar;
-
-        suu += wi * ui * ui;
-        suv += wi * ui * vi;
-        svv += wi * vi * vi;
-
-        suuu += wi * ui * ui * ui;
-        suvv += wi * ui * vi * vi;
-        svuu += wi * vi * ui * ui;
-        svvv += wi * vi * vi * vi;
-    }
-
-    const double det = suu * svv - suv * suv;
-
-    if (det == 0)
-    {
-        mWindE = 0;
-        mWindN = 0;
-        mVelAircraft = 0;
-        return;
-    }
-
-    const double uc = 1 / det * (0.5 * svv * (suuu + suvv) - 0.5 * suv * (svvv + svuu));
-    const double vc = 1 / det * (0.5 * suu * (svvv + svuu) - 0.5 * suv * (suuu + suvv));
-
-    const double xc = uc + xbar;
-    const double yc = vc + ybar;
-
-    const double alpha = uc * uc + vc * vc + (suu + svv) / N;
-    const double R = sqrt(alpha);
-
-    mWindE = xc;
-    mWindN = yc;
-    mVelAircraft = R;
+    Kinematics::fitWind(mMainWindow->data(), start, end,
+                        mWindE, mWindN, mVelAircraft);
 }
 
 void WindPlot::save()